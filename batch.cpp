@@ -0,0 +1,112 @@
+#include "batch.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "binary_graph.hpp"
+#include "certificate.hpp"
+#include "csr_graph.hpp"
+#include "parallel.hpp"
+#include "phase_matching.hpp"
+#include "stats.hpp"
+
+namespace ED {
+
+namespace {
+
+std::string const matching_suffix = ".matching";
+
+bool ends_with(std::string const &str, std::string const &suffix) {
+  return str.size() >= suffix.size() and
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::size_t solve_job(BatchJob const &job, MatchingOptions const &options,
+                      MatchingFormat const format, bool const verify,
+                      bool const certify) {
+  CsrGraph const graph = load_graph(job.input, 1, verify);
+  Matching const matching =
+      compute_maximum_cardinality_matching(graph, options);
+  if (certify and
+      not verify_maximum_matching(graph, matching,
+                                  find_tutte_berge_barrier(graph, matching))) {
+    throw std::runtime_error("Certificate of the matching rejected.");
+  }
+  BufferedWriter writer(job.output);
+  write_matching(writer, matching, format);
+  writer.flush();
+  return matching.num_edges();
+}
+
+} // namespace
+
+std::vector<BatchJob> list_batch_jobs(std::string const &source,
+                                      std::string const &output_directory) {
+  std::vector<std::string> inputs;
+  if (std::filesystem::is_directory(source)) {
+    for (auto const &entry : std::filesystem::directory_iterator(source)) {
+      std::string const path = entry.path().string();
+      if (entry.is_regular_file() and not ends_with(path, matching_suffix)) {
+        inputs.push_back(path);
+      }
+    }
+    std::sort(inputs.begin(), inputs.end());
+  } else {
+    std::ifstream file(source);
+    if (not file) {
+      throw std::runtime_error("Cannot open " + source + ".");
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+      if (not line.empty() and line[0] != '#') {
+        inputs.push_back(line);
+      }
+    }
+  }
+
+  std::vector<BatchJob> jobs;
+  jobs.reserve(inputs.size());
+  for (std::string const &input : inputs) {
+    std::filesystem::path output = input;
+    if (not output_directory.empty()) {
+      output = std::filesystem::path(output_directory) / output.filename();
+    }
+    jobs.push_back({input, output.string() + matching_suffix});
+  }
+  return jobs;
+}
+
+BatchResult solve_batch(std::vector<BatchJob> const &jobs,
+                        MatchingOptions const &options,
+                        MatchingFormat const format, bool const verify,
+                        bool const certify, unsigned const num_threads) {
+  MatchingOptions job_options = options;
+  job_options.num_threads = 1;
+  std::vector<std::size_t> matching_sizes(jobs.size(), 0);
+  BatchResult result;
+  result.errors.resize(jobs.size());
+
+  Stopwatch const stopwatch;
+  parallel_for(jobs.size(), num_threads, [&](std::size_t const job_idx) {
+    try {
+      matching_sizes[job_idx] = solve_job(jobs[job_idx], job_options, format,
+                                          verify, certify);
+    } catch (std::exception const &error) {
+      result.errors[job_idx] = error.what();
+    }
+  });
+  result.seconds = stopwatch.seconds();
+
+  for (std::size_t job_idx = 0; job_idx < jobs.size(); ++job_idx) {
+    if (result.errors[job_idx].empty()) {
+      ++result.num_solved;
+      result.num_matching_edges += matching_sizes[job_idx];
+    }
+  }
+  return result;
+}
+
+} // namespace ED
@@ -0,0 +1,67 @@
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+/**
+   @file batch.hpp
+
+   @brief Solving many graph files in one process: the files are handed out to
+a pool of threads, each of which solves one graph at a time.
+**/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "matching_writer.hpp"
+#include "maximum_cardinality_matching.hpp"
+
+namespace ED {
+
+//! A graph file and the file its matching is written to.
+struct BatchJob {
+  std::string input;
+  std::string output;
+};
+
+/**
+   @brief Lists the graph files given by @c source: all regular files of a
+directory (in name order, except files ending in ".matching"), or else the
+files named in a list file, one per line (empty lines and lines starting with
+'#' are skipped).
+
+   The matching of "dir/g.dmx" goes to "g.dmx.matching" in
+@c output_directory, or next to the input if @c output_directory is empty.
+Throws if @c source cannot be read.
+**/
+std::vector<BatchJob> list_batch_jobs(std::string const &source,
+                                      std::string const &output_directory);
+
+//! Outcome of @c solve_batch.
+struct BatchResult {
+  std::size_t num_solved = 0;
+  //! Sum of the matching sizes of all solved graphs
+  std::size_t num_matching_edges = 0;
+  double seconds = 0;
+  //! For every job, the error that stopped it, or an empty string
+  std::vector<std::string> errors;
+};
+
+/**
+   @brief Reads, solves and writes every job on @c num_threads threads.
+
+   Each graph is solved on a single thread with @c options, so that the
+threads work on different graphs and the search buffers of a thread are
+reused from graph to graph. With @c verify, the checksums of binary graph
+files are checked; with @c certify, every matching is checked against a
+Tutte-Berge barrier before it is written. A job that fails (unreadable file,
+rejected certificate, ...) does not stop the others, its error is recorded in
+the result.
+**/
+BatchResult solve_batch(std::vector<BatchJob> const &jobs,
+                        MatchingOptions const &options,
+                        MatchingFormat const format, bool const verify,
+                        bool const certify, unsigned const num_threads);
+
+} // namespace ED
+
+#endif /* BATCH_HPP */
@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream> // For the instance files and the results.
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "certificate.hpp"
+#include "csr_graph.hpp"
+#include "dynamic_matching.hpp"
+#include "generators.hpp"
+#include "graph.hpp"
+#include "initial_matching.hpp"
+#include "matching.hpp"
+#include "maximum_cardinality_matching.hpp"
+#include "phase_matching.hpp"
+
+namespace {
+
+using ED::NodeId;
+
+void print_usage(char const *program) {
+  std::cout << "Usage: " << program
+            << " [--nodes <n>] [--repetitions <n>] [--seed <n>]"
+               " [--threads <n>] [--family <name>]"
+               " [--engine edmonds|phases|incremental|parallel|hopcroft-karp]"
+               " [--no-kernel] [--updates <n>] [--output <file>]"
+            << std::endl;
+}
+
+//! A graph family with the parameters used by the benchmark.
+struct Family {
+  char const *name;
+  ED::GeneratedGraph (*generate)(NodeId num_nodes, std::uint64_t seed);
+};
+
+Family const families[] = {
+    {"erdos-renyi",
+     [](NodeId const num_nodes, std::uint64_t const seed) {
+       return ED::generate_erdos_renyi(num_nodes, 4.0, seed);
+     }},
+    {"random-regular",
+     [](NodeId const num_nodes, std::uint64_t const seed) {
+       return ED::generate_random_regular(num_nodes, 3, seed);
+     }},
+    {"grid",
+     [](NodeId const num_nodes, std::uint64_t const seed) {
+       NodeId const width = std::sqrt(double(num_nodes));
+       return ED::generate_grid(width, width, seed);
+     }},
+    {"bipartite",
+     [](NodeId const num_nodes, std::uint64_t const seed) {
+       return ED::generate_bipartite(num_nodes / 2, num_nodes - num_nodes / 2,
+                                     3 * num_nodes / 2, seed);
+     }},
+    {"power-law",
+     [](NodeId const num_nodes, std::uint64_t const seed) {
+       return ED::generate_power_law(num_nodes, 2, seed);
+     }},
+    {"odd-cycles",
+     [](NodeId const num_nodes, std::uint64_t const seed) {
+       return ED::generate_odd_cycle_chain(num_nodes, 5, seed);
+     }},
+};
+
+template <typename Function> double measure_seconds(Function const &function) {
+  auto const start = std::chrono::steady_clock::now();
+  function();
+  std::chrono::duration<double> const duration =
+      std::chrono::steady_clock::now() - start;
+  return duration.count();
+}
+
+double median(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  std::size_t const middle = samples.size() / 2;
+  return samples.size() % 2 == 1
+             ? samples[middle]
+             : (samples[middle - 1] + samples[middle]) / 2;
+}
+
+void write_timings(std::ostream &str, char const *phase,
+                   std::vector<double> const &samples) {
+  str << ", \"" << phase << "\": {\"min\": "
+      << *std::min_element(samples.begin(), samples.end())
+      << ", \"median\": " << median(samples) << ", \"max\": "
+      << *std::max_element(samples.begin(), samples.end()) << "}";
+}
+
+struct BenchOptions {
+  NodeId num_nodes = 100000;
+  unsigned repetitions = 3;
+  std::uint64_t seed = 1;
+  std::string family;
+  //! Random edge updates applied to a DynamicMatching per instance
+  unsigned num_updates = 0;
+  MatchingOptions matching_options;
+};
+
+// Applies random edge insertions and deletions to a DynamicMatching of the
+// instance and returns the time of each update. After every update, the
+// matching is checked against a matching computed from scratch and a
+// Tutte-Berge barrier of that one; a mismatch throws.
+std::vector<double> run_updates(ED::GeneratedGraph const &generated,
+                                BenchOptions const &options) {
+  ED::Graph graph(generated.num_nodes);
+  for (ED::Edge const &edge : generated.edges) {
+    graph.add_edge(edge.first, edge.second);
+  }
+  ED::DynamicMatching dynamic_matching(std::move(graph),
+                                       options.matching_options);
+  std::mt19937_64 random(options.seed);
+  std::vector<double> samples;
+  for (unsigned update = 0; update < options.num_updates; ++update) {
+    ED::Graph const &current = dynamic_matching.graph();
+    NodeId const node_id = random() % current.num_nodes();
+    if (random() % 2 == 0 and current.node(node_id).degree() > 0) {
+      std::vector<NodeId> const &neighbors =
+          current.node(node_id).neighbors();
+      NodeId const neighbor_id = neighbors[random() % neighbors.size()];
+      samples.push_back(measure_seconds(
+          [&] { dynamic_matching.delete_edge(node_id, neighbor_id); }));
+    } else {
+      NodeId const other_id = random() % current.num_nodes();
+      if (other_id == node_id) {
+        continue;
+      }
+      samples.push_back(measure_seconds(
+          [&] { dynamic_matching.insert_edge(node_id, other_id); }));
+    }
+
+    ED::CsrGraph const csr_graph(dynamic_matching.graph());
+    ED::Matching const reference =
+        compute_maximum_cardinality_matching(csr_graph,
+                                             options.matching_options);
+    if (dynamic_matching.matching().num_edges() != reference.num_edges() or
+        not ED::verify_maximum_matching(
+            csr_graph, dynamic_matching.matching(),
+            ED::find_tutte_berge_barrier(csr_graph, reference))) {
+      throw std::runtime_error("Dynamic matching is not maximum after update " +
+                               std::to_string(update) + ".");
+    }
+  }
+  return samples;
+}
+
+// Runs all phases on one instance and writes one line of JSON
+void run_family(Family const &family, BenchOptions const &options,
+                std::string const &instance_file, std::ostream &results) {
+  ED::GeneratedGraph const generated =
+      family.generate(options.num_nodes, options.seed);
+  {
+    std::ofstream file(instance_file);
+    file << ED::CsrGraph(generated.num_nodes, generated.edges);
+    if (not file) {
+      throw std::runtime_error("Cannot write " + instance_file + ".");
+    }
+  }
+
+  MatchingOptions const &matching_options = options.matching_options;
+  std::vector<double> load_graph_samples;
+  std::vector<double> load_samples;
+  std::vector<double> init_samples;
+  std::vector<double> solve_samples;
+  std::size_t matching_size = 0;
+  MatchingReport report;
+  for (unsigned run = 0; run < options.repetitions; ++run) {
+    load_graph_samples.push_back(
+        measure_seconds([&] { ED::Graph::build_graph(instance_file); }));
+    ED::CsrGraph graph(0, {});
+    load_samples.push_back(measure_seconds([&] {
+      graph = ED::CsrGraph::build_graph(instance_file,
+                                        matching_options.num_threads);
+    }));
+    init_samples.push_back(measure_seconds([&] {
+      ED::Matching matching(graph.num_nodes());
+      ED::initialize_matching(graph, matching, matching_options.initializer,
+                              matching_options.seed,
+                              matching_options.num_threads);
+    }));
+    std::size_t size = 0;
+    solve_samples.push_back(measure_seconds([&] {
+      size = compute_maximum_cardinality_matching(graph, matching_options,
+                                                  &report)
+                 .num_edges();
+    }));
+    if (run > 0 and size != matching_size) {
+      throw std::runtime_error("Matching sizes differ between runs.");
+    }
+    matching_size = size;
+  }
+  std::vector<double> update_samples;
+  if (options.num_updates > 0) {
+    update_samples = run_updates(generated, options);
+  }
+
+  results << "{\"family\": \"" << family.name
+          << "\", \"nodes\": " << generated.num_nodes
+          << ", \"edges\": " << generated.edges.size()
+          << ", \"seed\": " << options.seed
+          << ", \"threads\": " << matching_options.num_threads
+          << ", \"engine\": \"" << engine_name(report.engine)
+          << "\", \"kernel_nodes\": " << report.kernel_num_nodes
+          << ", \"matching\": " << matching_size
+          << ", \"repetitions\": " << options.repetitions;
+  write_timings(results, "load_graph", load_graph_samples);
+  write_timings(results, "load", load_samples);
+  write_timings(results, "init", init_samples);
+  write_timings(results, "solve", solve_samples);
+  if (not update_samples.empty()) {
+    results << ", \"updates\": " << update_samples.size();
+    write_timings(results, "update", update_samples);
+  }
+  results << "}" << std::endl;
+
+  std::cerr << family.name << ": " << generated.num_nodes << " nodes, "
+            << generated.edges.size() << " edges, matching " << matching_size
+            << "; median load " << median(load_samples) << " s, init "
+            << median(init_samples) << " s, solve " << median(solve_samples)
+            << " s";
+  if (not update_samples.empty()) {
+    std::cerr << ", " << update_samples.size() << " checked updates, median "
+              << median(update_samples) << " s";
+  }
+  std::cerr << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  BenchOptions options;
+  std::string output;
+  for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+    bool const has_value = arg_idx + 1 < argc;
+    if (std::strcmp(argv[arg_idx], "--nodes") == 0 and has_value) {
+      options.num_nodes = std::stoull(argv[++arg_idx]);
+    } else if (std::strcmp(argv[arg_idx], "--repetitions") == 0 and
+               has_value) {
+      options.repetitions = std::max(std::stoul(argv[++arg_idx]), 1ul);
+    } else if (std::strcmp(argv[arg_idx], "--seed") == 0 and has_value) {
+      options.seed = std::stoull(argv[++arg_idx]);
+    } else if (std::strcmp(argv[arg_idx], "--threads") == 0 and has_value) {
+      options.matching_options.num_threads =
+          std::max(std::stoul(argv[++arg_idx]), 1ul);
+    } else if (std::strcmp(argv[arg_idx], "--family") == 0 and has_value) {
+      options.family = argv[++arg_idx];
+    } else if (std::strcmp(argv[arg_idx], "--engine") == 0 and has_value and
+               parse_engine(argv[arg_idx + 1],
+                            options.matching_options.engine)) {
+      ++arg_idx;
+    } else if (std::strcmp(argv[arg_idx], "--updates") == 0 and has_value) {
+      options.num_updates = std::stoul(argv[++arg_idx]);
+    } else if (std::strcmp(argv[arg_idx], "--no-kernel") == 0) {
+      options.matching_options.reduce_graph = false;
+    } else if (std::strcmp(argv[arg_idx], "--output") == 0 and has_value) {
+      output = argv[++arg_idx];
+    } else {
+      print_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  bool const known_family =
+      options.family.empty() or
+      std::any_of(std::begin(families), std::end(families),
+                  [&](Family const &family) {
+                    return options.family == family.name;
+                  });
+  if (not known_family) {
+    std::cerr << "Unknown family " << options.family << ", known families:";
+    for (Family const &family : families) {
+      std::cerr << " " << family.name;
+    }
+    std::cerr << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ofstream output_file;
+  if (not output.empty()) {
+    output_file.open(output);
+  }
+  std::ostream &results = output.empty() ? std::cout : output_file;
+  std::string const instance_file =
+      (std::filesystem::temp_directory_path() /
+       ("ed-bench-" + std::to_string(::getpid()) + ".dmx"))
+          .string();
+  for (Family const &family : families) {
+    if (options.family.empty() or options.family == family.name) {
+      run_family(family, options, instance_file, results);
+    }
+  }
+  std::filesystem::remove(instance_file);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,224 @@
+#include "binary_graph.hpp" // always include corresponding header first
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "dimacs.hpp"
+
+namespace ED {
+
+namespace {
+
+static_assert(sizeof(NodeId) == sizeof(std::uint64_t) and
+                  sizeof(CsrGraph::size_type) == sizeof(std::uint64_t),
+              "The binary graph format stores 64-bit node ids and offsets.");
+
+// "EDCSRBIN" read as a native integer, so files with a different byte order
+// are rejected
+char constexpr magic_string[8] = {'E', 'D', 'C', 'S', 'R', 'B', 'I', 'N'};
+std::uint64_t constexpr version = 1;
+
+struct Header {
+  std::uint64_t magic;
+  std::uint64_t version;
+  std::uint64_t num_nodes;
+  std::uint64_t adjacency_size;
+  std::uint64_t checksum;
+  std::uint64_t reserved[3];
+};
+static_assert(sizeof(Header) == 64, "Unexpected header padding.");
+
+std::uint64_t magic() {
+  std::uint64_t value;
+  std::memcpy(&value, magic_string, sizeof(value));
+  return value;
+}
+
+// 64-bit FNV-1a over whole words
+class Checksum {
+public:
+  void add(std::uint64_t const *words, std::size_t const num_words) {
+    for (std::size_t idx = 0; idx < num_words; ++idx) {
+      _hash = (_hash ^ words[idx]) * 0x100000001b3ULL;
+    }
+  }
+  std::uint64_t value() const { return _hash; }
+
+private:
+  std::uint64_t _hash = 0xcbf29ce484222325ULL;
+};
+
+// Throws unless every list lies within the adjacency array and holds only
+// ids of other nodes. One pass that allocates nothing, so that nothing reads
+// out of bounds.
+void check_bounds(CsrGraph::size_type const *offsets, NodeId const *adjacency,
+                  NodeId const num_nodes) {
+  using size_type = CsrGraph::size_type;
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    if (offsets[node_id] > offsets[node_id + 1]) {
+      throw std::runtime_error("Binary graph file has inconsistent offsets.");
+    }
+    for (size_type idx = offsets[node_id]; idx < offsets[node_id + 1]; ++idx) {
+      NodeId const neighbor_id = adjacency[idx];
+      if (neighbor_id >= num_nodes) {
+        throw std::runtime_error(
+            "Binary graph file refers to a node that does not exist.");
+      }
+      if (neighbor_id == node_id) {
+        throw std::runtime_error("Binary graph file contains a loop.");
+      }
+    }
+  }
+}
+
+// Throws unless the adjacency lists (already within bounds) describe an
+// undirected graph: as many entries v in the list of u as u in that of v.
+// Transposing twice yields the lists sorted, transposing once yields the
+// sorted lists of the reverse graph, and the two agree iff the graph is
+// symmetric; both take O(n + m).
+void check_symmetry(CsrGraph::size_type const *offsets,
+                    NodeId const *adjacency, NodeId const num_nodes) {
+  using size_type = CsrGraph::size_type;
+  size_type const adjacency_size = offsets[num_nodes];
+  std::vector<size_type> in_degrees(num_nodes, 0);
+  for (size_type idx = 0; idx < adjacency_size; ++idx) {
+    ++in_degrees[adjacency[idx]];
+  }
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    if (in_degrees[node_id] != offsets[node_id + 1] - offsets[node_id]) {
+      throw std::runtime_error("Binary graph file is not symmetric.");
+    }
+  }
+
+  // With matching degrees, both transposes fit into the same offsets
+  auto const transpose = [&](NodeId const *lists, std::vector<NodeId> &result) {
+    std::vector<size_type> next(offsets, offsets + num_nodes);
+    result.resize(adjacency_size);
+    for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+      for (size_type idx = offsets[node_id]; idx < offsets[node_id + 1];
+           ++idx) {
+        result[next[lists[idx]]++] = node_id;
+      }
+    }
+  };
+  std::vector<NodeId> reverse_lists;
+  std::vector<NodeId> sorted_lists;
+  transpose(adjacency, reverse_lists);
+  transpose(reverse_lists.data(), sorted_lists);
+  if (reverse_lists != sorted_lists) {
+    throw std::runtime_error("Binary graph file is not symmetric.");
+  }
+}
+
+} // namespace
+
+void write_binary_graph(CsrGraph const &graph, const std::string &filename) {
+  std::uint64_t const num_offsets = graph.num_nodes() + 1;
+  std::uint64_t const adjacency_size = 2 * graph.num_edges();
+
+  Checksum checksum;
+  checksum.add(reinterpret_cast<std::uint64_t const *>(graph.offsets()),
+               num_offsets);
+  checksum.add(reinterpret_cast<std::uint64_t const *>(graph.adjacency()),
+               adjacency_size);
+
+  Header header{};
+  header.magic = magic();
+  header.version = version;
+  header.num_nodes = graph.num_nodes();
+  header.adjacency_size = adjacency_size;
+  header.checksum = checksum.value();
+
+  std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    throw std::runtime_error("Could not open output file.");
+  }
+  ofs.write(reinterpret_cast<char const *>(&header), sizeof(header));
+  ofs.write(reinterpret_cast<char const *>(graph.offsets()),
+            num_offsets * sizeof(std::uint64_t));
+  ofs.write(reinterpret_cast<char const *>(graph.adjacency()),
+            adjacency_size * sizeof(std::uint64_t));
+  if (!ofs) {
+    throw std::runtime_error("Could not write output file.");
+  }
+}
+
+CsrGraph load_binary_graph(const std::string &filename, bool const verify) {
+  return load_binary_graph(
+      std::make_shared<MappedFile const>(filename, MappedFile::Access::normal),
+      verify);
+}
+
+CsrGraph load_binary_graph(std::shared_ptr<MappedFile const> file,
+                           bool const verify) {
+  if (file->size() < sizeof(Header)) {
+    throw std::runtime_error("Binary graph file is too short.");
+  }
+  Header header;
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (header.magic != magic()) {
+    throw std::runtime_error("Not a binary graph file (or wrong byte order).");
+  }
+  if (header.version != version) {
+    throw std::runtime_error("Unsupported binary graph file version.");
+  }
+  std::uint64_t const num_offsets = header.num_nodes + 1;
+  if (header.num_nodes >= file->size() or
+      header.adjacency_size >= file->size() or
+      header.adjacency_size % 2 != 0 or
+      file->size() != sizeof(Header) + (num_offsets + header.adjacency_size) *
+                                           sizeof(std::uint64_t)) {
+    throw std::runtime_error("Binary graph file has an unexpected size.");
+  }
+
+  auto const *offsets =
+      reinterpret_cast<CsrGraph::size_type const *>(file->data() + sizeof(Header));
+  auto const *adjacency = reinterpret_cast<NodeId const *>(offsets + num_offsets);
+  if (offsets[0] != 0 or offsets[header.num_nodes] != header.adjacency_size) {
+    throw std::runtime_error("Binary graph file has inconsistent offsets.");
+  }
+
+  if (verify) {
+    Checksum checksum;
+    checksum.add(reinterpret_cast<std::uint64_t const *>(offsets), num_offsets);
+    checksum.add(reinterpret_cast<std::uint64_t const *>(adjacency),
+                 header.adjacency_size);
+    if (checksum.value() != header.checksum) {
+      throw std::runtime_error("Binary graph file checksum mismatch.");
+    }
+  }
+  check_bounds(offsets, adjacency, header.num_nodes);
+  if (verify) {
+    check_symmetry(offsets, adjacency, header.num_nodes);
+  }
+
+  return CsrGraph(std::move(file), offsets, adjacency, header.num_nodes);
+}
+
+bool is_binary_graph(MappedFile const &file) {
+  std::uint64_t value = 0;
+  if (file.size() < sizeof(value)) {
+    return false;
+  }
+  std::memcpy(&value, file.data(), sizeof(value));
+  return value == magic();
+}
+
+CsrGraph load_graph(const std::string &filename, unsigned const num_threads,
+                    bool const verify) {
+  auto file =
+      std::make_shared<MappedFile const>(filename, MappedFile::Access::normal);
+  if (is_binary_graph(*file)) {
+    return load_binary_graph(std::move(file), verify);
+  }
+  file->advise(MappedFile::Access::sequential);
+  DimacsInstance const instance = read_dimacs(*file, num_threads);
+  file.reset();
+  return CsrGraph(instance.num_nodes, instance.edges, num_threads);
+}
+
+} // namespace ED
@@ -0,0 +1,64 @@
+#ifndef BINARY_GRAPH_HPP
+#define BINARY_GRAPH_HPP
+
+/**
+   @file binary_graph.hpp
+
+   @brief A compact binary file format for @c CsrGraph s that can be loaded
+without parsing or copying.
+
+   Layout (all fields 64-bit unsigned integers in native byte order):
+   - header: magic, version, number of nodes, length of the adjacency array
+     (twice the number of edges), checksum, three reserved fields
+   - offsets array (<tt>num_nodes + 1</tt> entries)
+   - adjacency array
+
+   The checksum covers the offsets and the adjacency array.
+**/
+
+#include <memory>
+#include <string>
+
+#include "csr_graph.hpp"
+#include "mapped_file.hpp"
+
+namespace ED {
+
+/** @brief Writes @c graph to @c filename in the binary graph format. **/
+void write_binary_graph(CsrGraph const &graph, const std::string &filename);
+
+/**
+   @brief Memory-maps a binary graph file and returns a @c CsrGraph that reads
+its arrays directly from the mapping.
+
+   Besides the header and the array sizes, one pass that allocates nothing
+checks that the offsets do not decrease and that every neighbor is a node of
+the graph other than the node itself, so a damaged file cannot make the solver
+read out of bounds. With @c verify, the checksum is compared as well, and the
+adjacency is checked to be symmetric, as @c CsrGraph requires; this takes
+O(n + m) time and memory for two transposes.
+**/
+CsrGraph load_binary_graph(const std::string &filename,
+                           bool const verify = false);
+
+/** @brief Like the above, for a file that is already open. **/
+CsrGraph load_binary_graph(std::shared_ptr<MappedFile const> file,
+                           bool const verify = false);
+
+/** @return Whether @c file starts with the magic of the binary format. **/
+bool is_binary_graph(MappedFile const &file);
+
+/**
+   @brief Loads a graph from a binary graph file (see @c load_binary_graph) or
+else from a DIMACS file, parsed with up to @c num_threads threads.
+
+   The file is opened once and its first bytes are looked at in memory, so
+pipes and other files that can only be read once work as well.
+**/
+CsrGraph load_graph(const std::string &filename,
+                    unsigned const num_threads = 1,
+                    bool const verify = false);
+
+} // namespace ED
+
+#endif /* BINARY_GRAPH_HPP */
@@ -0,0 +1,244 @@
+#include "bipartite_matching.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace ED {
+
+namespace {
+
+std::uint8_t constexpr no_side = 2;
+std::uint32_t constexpr infinite_distance =
+    std::numeric_limits<std::uint32_t>::max();
+
+// Layers smaller than this are expanded on one thread
+std::size_t constexpr min_parallel_layer_size = 1 << 14;
+
+class HopcroftKarp {
+public:
+  HopcroftKarp(CsrGraph const &graph, std::vector<std::uint8_t> const &sides,
+               Matching &matching, unsigned const num_threads)
+      : _graph(graph), _matching(matching),
+        _num_threads(std::max(num_threads, 1u)), _distance(graph.num_nodes()),
+        _next_arc(graph.num_nodes()), _lookahead(graph.num_nodes()),
+        _next_layers(_num_threads) {
+    for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+      if (sides[node_id] == 0 and graph.node(node_id).degree() > 0) {
+        _roots.push_back(node_id);
+      }
+    }
+  }
+
+  // Builds the layers of the next phase, returns false if there is no
+  // augmenting path
+  bool build_layers();
+  // Augments along a maximal set of vertex-disjoint augmenting paths that
+  // follow the layers; the lookahead ends a path at the first exposed
+  // neighbor, so paths may be longer than the shortest ones
+  void augment_along_layers();
+
+private:
+  std::uint32_t distance(NodeId const node_id) const {
+    return _distance[node_id].load(std::memory_order_relaxed);
+  }
+  void set_distance(NodeId const node_id, std::uint32_t const distance) {
+    _distance[node_id].store(distance, std::memory_order_relaxed);
+  }
+
+  // Appends the unvisited side-0 nodes reached from node_id to next_layer,
+  // returns whether node_id has an exposed neighbor
+  bool expand(NodeId node_id, std::uint32_t distance,
+              std::vector<NodeId> &next_layer);
+  bool augment_from(NodeId root);
+
+  CsrGraph const &_graph;
+  Matching &_matching;
+  unsigned const _num_threads;
+  // Distance of side-0 nodes from the exposed side-0 nodes
+  std::vector<std::atomic<std::uint32_t>> _distance;
+  // Index of the next neighbor to try in the depth-first search, and of the
+  // next neighbor to check for being exposed (lookahead)
+  std::vector<NodeId> _next_arc;
+  std::vector<NodeId> _lookahead;
+  // Exposed side-0 nodes, matched ones are removed lazily
+  std::vector<NodeId> _roots;
+  std::vector<NodeId> _layer;
+  std::vector<std::vector<NodeId>> _next_layers; // one per thread
+  std::vector<NodeId> _stack;
+  std::vector<NodeId> _path;
+};
+
+bool HopcroftKarp::expand(NodeId const node_id, std::uint32_t const distance,
+                          std::vector<NodeId> &next_layer) {
+  bool found = false;
+  for (NodeId const neighbor_id : _graph.node(node_id).neighbors()) {
+    NodeId const mate_id = _matching.mate(neighbor_id);
+    if (mate_id == invalid_node_id) {
+      found = true;
+      continue;
+    }
+    std::uint32_t expected = infinite_distance;
+    if (this->distance(mate_id) == infinite_distance and
+        _distance[mate_id].compare_exchange_strong(
+            expected, distance + 1, std::memory_order_relaxed)) {
+      next_layer.push_back(mate_id);
+    }
+  }
+  return found;
+}
+
+bool HopcroftKarp::build_layers() {
+  for (NodeId node_id = 0; node_id < _graph.num_nodes(); ++node_id) {
+    set_distance(node_id, infinite_distance);
+  }
+  _roots.erase(std::remove_if(_roots.begin(), _roots.end(),
+                              [&](NodeId const node_id) {
+                                return not _matching.is_exposed(node_id);
+                              }),
+               _roots.end());
+  _layer = _roots;
+  for (NodeId const root_id : _roots) {
+    set_distance(root_id, 0);
+  }
+
+  // All layers are built, not only those up to the first one with an exposed
+  // neighbor, so that augmenting paths can end in any layer
+  std::atomic<bool> found(false);
+  for (std::uint32_t distance = 0; not _layer.empty(); ++distance) {
+    if (_num_threads == 1 or _layer.size() < min_parallel_layer_size) {
+      _next_layers[0].clear();
+      for (NodeId const node_id : _layer) {
+        if (expand(node_id, distance, _next_layers[0])) {
+          found = true;
+        }
+      }
+      _layer.swap(_next_layers[0]);
+    } else {
+      for (std::vector<NodeId> &next_layer : _next_layers) {
+        next_layer.clear();
+      }
+      std::size_t const num_blocks = 4 * _num_threads;
+      parallel_for_workers(
+          num_blocks, _num_threads,
+          [&](std::size_t const worker_idx, std::size_t const block_idx) {
+            std::size_t const begin = _layer.size() * block_idx / num_blocks;
+            std::size_t const end =
+                _layer.size() * (block_idx + 1) / num_blocks;
+            for (std::size_t idx = begin; idx < end; ++idx) {
+              if (expand(_layer[idx], distance, _next_layers[worker_idx])) {
+                found.store(true, std::memory_order_relaxed);
+              }
+            }
+          });
+      _layer.clear();
+      for (std::vector<NodeId> const &next_layer : _next_layers) {
+        _layer.insert(_layer.end(), next_layer.begin(), next_layer.end());
+      }
+    }
+  }
+  return found;
+}
+
+// Iterative depth-first search along the layers. Nodes from which no
+// augmenting path was found, and nodes on the path used, are removed from the
+// layers by setting their distance to infinity.
+bool HopcroftKarp::augment_from(NodeId const root) {
+  _stack.assign(1, root);
+  while (not _stack.empty()) {
+    NodeId const node_id = _stack.back();
+    NeighborRange const neighbors = _graph.node(node_id).neighbors();
+    // An exposed neighbor ends the path at once, so look for one before
+    // descending (Pothen and Fan)
+    NodeId neighbor_id = invalid_node_id;
+    while (_lookahead[node_id] < neighbors.size()) {
+      NodeId const candidate_id = neighbors[_lookahead[node_id]++];
+      if (_matching.is_exposed(candidate_id)) {
+        neighbor_id = candidate_id;
+        break;
+      }
+    }
+    if (neighbor_id == invalid_node_id) {
+      if (_next_arc[node_id] == neighbors.size()) {
+        set_distance(node_id, infinite_distance);
+        _stack.pop_back();
+        continue;
+      }
+      neighbor_id = neighbors[_next_arc[node_id]++];
+    }
+    NodeId const mate_id = _matching.mate(neighbor_id);
+    if (mate_id == invalid_node_id) {
+
+      // Path: neighbor_id, then back along the stack
+      _path.assign(1, neighbor_id);
+      for (std::size_t idx = _stack.size(); idx-- > 0;) {
+        _path.push_back(_stack[idx]);
+        if (idx > 0) {
+          NodeId const parent_id = _stack[idx - 1];
+          _path.push_back(
+              _graph.node(parent_id).neighbors()[_next_arc[parent_id] - 1]);
+        }
+        set_distance(_stack[idx], infinite_distance);
+      }
+      _matching.augment(_path);
+      return true;
+    }
+    if (distance(mate_id) == distance(node_id) + 1) {
+      _stack.push_back(mate_id);
+    }
+  }
+  return false;
+}
+
+void HopcroftKarp::augment_along_layers() {
+  std::fill(_next_arc.begin(), _next_arc.end(), 0);
+  std::fill(_lookahead.begin(), _lookahead.end(), 0);
+  for (NodeId const root_id : _roots) {
+    augment_from(root_id);
+  }
+}
+
+} // namespace
+
+bool find_bipartition(CsrGraph const &graph,
+                      std::vector<std::uint8_t> &sides) {
+  sides.assign(graph.num_nodes(), no_side);
+  std::vector<NodeId> queue;
+  for (NodeId start_id = 0; start_id < graph.num_nodes(); ++start_id) {
+    if (sides[start_id] != no_side) {
+      continue;
+    }
+    sides[start_id] = 0;
+    queue.assign(1, start_id);
+    for (std::size_t queue_idx = 0; queue_idx < queue.size(); ++queue_idx) {
+      NodeId const node_id = queue[queue_idx];
+      for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+        if (sides[neighbor_id] == no_side) {
+          sides[neighbor_id] = 1 - sides[node_id];
+          queue.push_back(neighbor_id);
+        } else if (sides[neighbor_id] == sides[node_id]) {
+          return false; // odd cycle
+        }
+      }
+    }
+  }
+  return true;
+}
+
+std::size_t augment_hopcroft_karp(CsrGraph const &graph,
+                                  std::vector<std::uint8_t> const &sides,
+                                  Matching &matching,
+                                  unsigned const num_threads) {
+  HopcroftKarp search(graph, sides, matching, num_threads);
+  std::size_t num_phases = 0;
+  while (search.build_layers()) {
+    search.augment_along_layers();
+    ++num_phases;
+  }
+  return num_phases;
+}
+
+} // namespace ED
@@ -0,0 +1,55 @@
+#ifndef BIPARTITE_MATCHING_HPP
+#define BIPARTITE_MATCHING_HPP
+
+/**
+   @file bipartite_matching.hpp
+
+   @brief Bipartiteness test and the Hopcroft-Karp algorithm, which needs no
+blossoms.
+**/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+/**
+   @brief Tries to 2-color @c graph by breadth-first search in O(n + m) time.
+
+   @return Whether @c graph is bipartite. If so, @c sides[node_id] is 0 or 1
+for every node and every edge connects nodes of different sides.
+**/
+bool find_bipartition(CsrGraph const &graph,
+                      std::vector<std::uint8_t> &sides);
+
+/**
+   @brief Augments @c matching to a maximum matching of the bipartite graph
+@c graph with the Hopcroft-Karp algorithm.
+
+   Every phase computes the distances of the side-0 nodes from the exposed
+side-0 nodes by a breadth-first search along alternating paths, and then
+augments along a maximal set of vertex-disjoint augmenting paths that follow
+the layers of the search, found by depth-first searches that check for an
+exposed neighbor before descending. Each phase takes O(m) time. Unlike in the
+textbook algorithm, paths are not restricted to the shortest ones, so the
+bound of O(sqrt(n)) phases is not guaranteed; in exchange, a phase finds many
+more paths, and far fewer phases are needed on large sparse graphs.
+
+   With several threads, each large layer of the breadth-first search is
+expanded in parallel; the result does not depend on the number of threads.
+
+   @param sides A bipartition as computed by @c find_bipartition.
+   @return The number of phases.
+**/
+std::size_t augment_hopcroft_karp(CsrGraph const &graph,
+                                  std::vector<std::uint8_t> const &sides,
+                                  Matching &matching,
+                                  unsigned const num_threads = 1);
+
+} // namespace ED
+
+#endif /* BIPARTITE_MATCHING_HPP */
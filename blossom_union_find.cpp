@@ -0,0 +1,73 @@
+#include "blossom_union_find.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <utility>
+
+namespace ED {
+
+BlossomUnionFind::BlossomUnionFind(NodeId const num_nodes)
+    : _stamps(num_nodes, 0), _parent(num_nodes), _rank(num_nodes),
+      _base(num_nodes), _cycle_idx(num_nodes) {}
+
+void BlossomUnionFind::begin_tree() {
+  if (++_epoch == 0) {
+    std::fill(_stamps.begin(), _stamps.end(), 0);
+    _epoch = 1;
+  }
+}
+
+NodeId BlossomUnionFind::find(NodeId id) const {
+  if (not in_blossom(id)) {
+    return id;
+  }
+  NodeId root = id;
+  while (_parent[root] != root) {
+    root = _parent[root];
+  }
+  // Path compression
+  while (_parent[id] != root) {
+    NodeId const next = _parent[id];
+    _parent[id] = root;
+    id = next;
+  }
+  return root;
+}
+
+void BlossomUnionFind::make_singleton(NodeId const id) {
+  _stamps[id] = _epoch;
+  _parent[id] = id;
+  _rank[id] = 0;
+  _base[id] = id;
+}
+
+NodeId BlossomUnionFind::unite(NodeId const a, NodeId const b) {
+  if (not in_blossom(a)) {
+    make_singleton(a);
+  }
+  if (not in_blossom(b)) {
+    make_singleton(b);
+  }
+  NodeId root_a = find(a);
+  NodeId root_b = find(b);
+  if (root_a == root_b) {
+    return root_a;
+  }
+  // Union by rank
+  if (_rank[root_a] < _rank[root_b]) {
+    std::swap(root_a, root_b);
+  }
+  _parent[root_b] = root_a;
+  if (_rank[root_a] == _rank[root_b]) {
+    ++_rank[root_a];
+  }
+  return root_a;
+}
+
+void BlossomUnionFind::set_blossom(NodeId const id, NodeId const base,
+                                   size_t const cycle_idx) {
+  NodeId const root = find(id);
+  _base[root] = base;
+  _cycle_idx[root] = cycle_idx;
+}
+
+} // namespace ED
@@ -0,0 +1,82 @@
+#ifndef BLOSSOM_UNION_FIND_HPP
+#define BLOSSOM_UNION_FIND_HPP
+
+/**
+   @file blossom_union_find.hpp
+
+   @brief Union-find structure modelling the (nested) blossoms that have been
+shrunk in the current alternating tree.
+**/
+
+#include <cstdint>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace ED {
+
+/**
+   @class BlossomUnionFind
+
+   @brief Disjoint sets of nodes with path compression and union by rank. Each
+set stores its base (the node connected to the predecessor of the blossom) and
+the index of the cycle whose contraction created it.
+
+   Nodes that have never been shrunk into a blossom since the last call of @c
+begin_tree() are singletons whose base is the node itself, so @c base() is an
+array access for them. Like @c SolverState, the structure uses epoch stamps to
+be reset in O(1).
+**/
+class BlossomUnionFind {
+public:
+  explicit BlossomUnionFind(NodeId const num_nodes);
+
+  /** @brief Makes every node a singleton again. **/
+  void begin_tree();
+
+  /**
+     @brief Makes @c id a singleton again.
+     @warning All other nodes of its set have to be reset as well.
+  **/
+  void reset(NodeId const id) { _stamps[id] = 0; }
+
+  /** @return Whether @c id has been shrunk into a blossom in this tree. **/
+  bool in_blossom(NodeId const id) const { return _stamps[id] == _epoch; }
+
+  /** @return The representative of the set containing @c id. **/
+  NodeId find(NodeId id) const;
+
+  /** @return The base of the outermost blossom containing @c id. **/
+  NodeId base(NodeId const id) const {
+    return in_blossom(id) ? _base[find(id)] : id;
+  }
+
+  /** @return The index of the cycle that created the outermost blossom
+      containing @c id. @warning Requires @c in_blossom(id). **/
+  size_t cycle_idx(NodeId const id) const { return _cycle_idx[find(id)]; }
+
+  /**
+     @brief Merges the sets containing @c a and @c b (singletons are added to
+  the structure first).
+     @return The representative of the merged set.
+  **/
+  NodeId unite(NodeId const a, NodeId const b);
+
+  /** @brief Sets base and cycle index of the set containing @c id. **/
+  void set_blossom(NodeId const id, NodeId const base, size_t const cycle_idx);
+
+private:
+  void make_singleton(NodeId const id);
+
+  std::uint32_t _epoch = 1;
+  std::vector<std::uint32_t> _stamps;
+  // Path compression does not change the represented sets
+  mutable std::vector<NodeId> _parent;
+  std::vector<std::uint8_t> _rank;
+  std::vector<NodeId> _base;
+  std::vector<size_t> _cycle_idx;
+};
+
+} // namespace ED
+
+#endif /* BLOSSOM_UNION_FIND_HPP */
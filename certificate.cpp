@@ -0,0 +1,142 @@
+#include "certificate.hpp" // always include corresponding header first
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "parallel.hpp"
+
+namespace ED {
+
+namespace {
+
+// Union-find that threads may update concurrently. A root is only ever linked
+// below a smaller node id, so parents never increase and no cycles can form;
+// linking and path halving are compare-and-swaps on the parents.
+class ConcurrentUnionFind {
+public:
+  explicit ConcurrentUnionFind(NodeId const num_nodes,
+                               unsigned const num_threads)
+      : _parent(num_nodes) {
+    parallel_for_blocks(num_nodes, num_threads,
+                        [&](std::size_t const begin, std::size_t const end) {
+                          for (std::size_t idx = begin; idx < end; ++idx) {
+                            _parent[idx].store(idx, std::memory_order_relaxed);
+                          }
+                        });
+  }
+
+  NodeId find(NodeId node_id) {
+    while (true) {
+      NodeId parent_id = _parent[node_id].load();
+      if (parent_id == node_id) {
+        return node_id;
+      }
+      NodeId const grandparent_id = _parent[parent_id].load();
+      if (grandparent_id != parent_id) {
+        _parent[node_id].compare_exchange_weak(parent_id, grandparent_id);
+      }
+      node_id = grandparent_id;
+    }
+  }
+
+  void unite(NodeId first_id, NodeId second_id) {
+    while (true) {
+      first_id = find(first_id);
+      second_id = find(second_id);
+      if (first_id == second_id) {
+        return;
+      }
+      if (first_id < second_id) {
+        std::swap(first_id, second_id);
+      }
+      NodeId expected_id = first_id;
+      if (_parent[first_id].compare_exchange_strong(expected_id, second_id)) {
+        return;
+      }
+    }
+  }
+
+private:
+  std::vector<std::atomic<NodeId>> _parent;
+}; // class ConcurrentUnionFind
+
+} // namespace
+
+bool verify_maximum_matching(CsrGraph const &graph, Matching const &matching,
+                             std::vector<NodeId> const &barrier,
+                             unsigned const num_threads) {
+  NodeId const num_nodes = graph.num_nodes();
+  if (matching.num_nodes() != num_nodes) {
+    return false;
+  }
+  std::vector<bool> in_barrier(num_nodes, false);
+  for (NodeId const node_id : barrier) {
+    if (node_id >= num_nodes or in_barrier[node_id]) {
+      return false;
+    }
+    in_barrier[node_id] = true;
+  }
+
+  // One pass over the edges checks the mates and joins the components of the
+  // graph without the barrier
+  std::atomic<bool> valid(true);
+  std::atomic<std::size_t> num_matched_nodes(0);
+  ConcurrentUnionFind components(num_nodes, num_threads);
+  parallel_for_blocks(
+      num_nodes, num_threads,
+      [&](std::size_t const begin, std::size_t const end) {
+        std::size_t num_matched = 0;
+        for (NodeId node_id = begin; node_id < end; ++node_id) {
+          NodeId const mate_id = matching.mate(node_id);
+          bool mate_found = mate_id == invalid_node_id;
+          if (not mate_found) {
+            ++num_matched;
+            if (matching.mate(mate_id) != node_id) {
+              valid = false;
+            }
+          }
+          for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+            mate_found |= neighbor_id == mate_id;
+            if (node_id < neighbor_id and not in_barrier[node_id] and
+                not in_barrier[neighbor_id]) {
+              components.unite(node_id, neighbor_id);
+            }
+          }
+          if (not mate_found) {
+            valid = false;
+          }
+        }
+        num_matched_nodes += num_matched;
+      });
+  if (not valid or num_matched_nodes != 2 * matching.num_edges()) {
+    return false;
+  }
+
+  // The parity of every component is collected at its root
+  std::vector<std::atomic<std::uint8_t>> parities(num_nodes);
+  parallel_for_blocks(num_nodes, num_threads,
+                      [&](std::size_t const begin, std::size_t const end) {
+                        for (NodeId node_id = begin; node_id < end; ++node_id) {
+                          if (not in_barrier[node_id]) {
+                            parities[components.find(node_id)] ^= 1;
+                          }
+                        }
+                      });
+  std::atomic<std::size_t> num_odd_components(0);
+  parallel_for_blocks(num_nodes, num_threads,
+                      [&](std::size_t const begin, std::size_t const end) {
+                        std::size_t num_odd = 0;
+                        for (NodeId node_id = begin; node_id < end; ++node_id) {
+                          num_odd += parities[node_id];
+                        }
+                        num_odd_components += num_odd;
+                      });
+
+  // Every matching has at most (n + |A| - odd(G - A)) / 2 edges
+  return 2 * matching.num_edges() + num_odd_components >=
+         num_nodes + barrier.size();
+}
+
+} // namespace ED
@@ -0,0 +1,39 @@
+#ifndef CERTIFICATE_HPP
+#define CERTIFICATE_HPP
+
+/**
+   @file certificate.hpp
+
+   @brief Checking that a matching is maximum against a Tutte-Berge barrier,
+independently of the algorithm that computed either of them.
+**/
+
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+/**
+   @brief Checks that @c matching is a maximum matching of @c graph, with
+@c barrier as the witness.
+
+   For every node set A, no matching has more than (n + |A| - odd(G - A)) / 2
+edges, where odd(G - A) is the number of components of odd size of the graph
+without A (Tutte-Berge formula). The check accepts if @c matching is a matching
+of @c graph (mates are symmetric and adjacent) that attains this bound for
+A = @c barrier. A barrier from @c find_tutte_berge_barrier always attains it
+for a maximum matching.
+
+   Takes O((n + m) alpha(n)) time: the components of G - A come from a
+concurrent union-find over the edges, and all passes are split over
+@c num_threads threads.
+**/
+bool verify_maximum_matching(CsrGraph const &graph, Matching const &matching,
+                             std::vector<NodeId> const &barrier,
+                             unsigned const num_threads = 1);
+
+} // namespace ED
+
+#endif /* CERTIFICATE_HPP */
@@ -0,0 +1,87 @@
+#include "components.hpp" // always include corresponding header first
+
+#include <memory>
+#include <utility>
+
+namespace ED {
+
+namespace {
+
+struct SubgraphArrays {
+  std::vector<size_type> offsets;
+  std::vector<NodeId> adjacency;
+};
+
+std::size_t constexpr no_component = invalid_node_id;
+
+} // namespace
+
+Components find_components(CsrGraph const &graph) {
+  // Component of every node, numbered in order of discovery
+  std::vector<std::size_t> component_of(graph.num_nodes(), no_component);
+  std::vector<NodeId> queue;
+  std::size_t num_components = 0;
+  Components components;
+  for (NodeId start_id = 0; start_id < graph.num_nodes(); ++start_id) {
+    if (component_of[start_id] != no_component) {
+      continue;
+    }
+    component_of[start_id] = num_components;
+    queue.assign(1, start_id);
+    std::size_t degree_sum = 0;
+    for (std::size_t queue_idx = 0; queue_idx < queue.size(); ++queue_idx) {
+      NeighborRange const neighbors = graph.node(queue[queue_idx]).neighbors();
+      degree_sum += neighbors.size();
+      for (NodeId const neighbor_id : neighbors) {
+        if (component_of[neighbor_id] == no_component) {
+          component_of[neighbor_id] = num_components;
+          queue.push_back(neighbor_id);
+        }
+      }
+    }
+    components.num_edges.push_back(degree_sum / 2);
+    ++num_components;
+  }
+
+  // Group the nodes by component with a counting sort, which keeps them in
+  // increasing order within each component
+  components.offsets.assign(num_components + 1, 0);
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    ++components.offsets[component_of[node_id] + 1];
+  }
+  for (std::size_t idx = 0; idx < num_components; ++idx) {
+    components.offsets[idx + 1] += components.offsets[idx];
+  }
+  components.nodes.resize(graph.num_nodes());
+  components.local_ids.resize(graph.num_nodes());
+  std::vector<std::size_t> positions(components.offsets.begin(),
+                                     components.offsets.end() - 1);
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    std::size_t const component_idx = component_of[node_id];
+    components.local_ids[node_id] =
+        positions[component_idx] - components.offsets[component_idx];
+    components.nodes[positions[component_idx]++] = node_id;
+  }
+  return components;
+}
+
+CsrGraph component_subgraph(CsrGraph const &graph,
+                            Components const &components,
+                            std::size_t const component_idx) {
+  NodeId const num_nodes = components.num_nodes(component_idx);
+  auto arrays = std::make_shared<SubgraphArrays>();
+  arrays->offsets.assign(num_nodes + 1, 0);
+  arrays->adjacency.reserve(2 * components.num_edges[component_idx]);
+  for (NodeId local_id = 0; local_id < num_nodes; ++local_id) {
+    for (NodeId const neighbor_id :
+         graph.node(components.node(component_idx, local_id)).neighbors()) {
+      arrays->adjacency.push_back(components.local_ids[neighbor_id]);
+    }
+    arrays->offsets[local_id + 1] = arrays->adjacency.size();
+  }
+  size_type const *const offsets = arrays->offsets.data();
+  NodeId const *const adjacency = arrays->adjacency.data();
+  return CsrGraph(std::move(arrays), offsets, adjacency, num_nodes);
+}
+
+} // namespace ED
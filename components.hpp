@@ -0,0 +1,57 @@
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+/**
+   @file components.hpp
+
+   @brief Decomposition of a graph into its connected components, each of
+which can be turned into a compact @c CsrGraph of its own.
+**/
+
+#include <cstddef>
+#include <vector>
+
+#include "csr_graph.hpp"
+
+namespace ED {
+
+/**
+   @brief The connected components of a graph.
+
+   The nodes of component @c c are <tt>nodes[offsets[c]], ...,
+nodes[offsets[c + 1] - 1]</tt> in increasing order, and the id of node @c v in
+the graph of its component is @c local_ids[v]. Components are numbered by
+their smallest node.
+**/
+struct Components {
+  std::vector<NodeId> nodes;
+  std::vector<std::size_t> offsets;
+  std::vector<NodeId> local_ids;
+  //! Number of edges of every component
+  std::vector<std::size_t> num_edges;
+
+  std::size_t num_components() const { return offsets.size() - 1; }
+  NodeId num_nodes(std::size_t const component_idx) const {
+    return offsets[component_idx + 1] - offsets[component_idx];
+  }
+  //! Original id of the node with the given local id in the component
+  NodeId node(std::size_t const component_idx, NodeId const local_id) const {
+    return nodes[offsets[component_idx] + local_id];
+  }
+};
+
+/** @brief Labels the components by breadth-first search in O(n + m) time. **/
+Components find_components(CsrGraph const &graph);
+
+/**
+   @brief Copies a component into a graph on the nodes <tt>0, ...,
+components.num_nodes(component_idx) - 1</tt> (the local ids). The adjacency
+lists keep their order.
+**/
+CsrGraph component_subgraph(CsrGraph const &graph,
+                            Components const &components,
+                            std::size_t const component_idx);
+
+} // namespace ED
+
+#endif /* COMPONENTS_HPP */
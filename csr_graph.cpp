@@ -0,0 +1,198 @@
+#include "csr_graph.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "dimacs.hpp"
+#include "parallel.hpp"
+
+namespace ED {
+
+namespace {
+
+void check_edge(Edge const &edge, NodeId const num_nodes) {
+  if (edge.first == edge.second) {
+    throw std::runtime_error("ED::CsrGraph class does not support loops!");
+  }
+  if (edge.first >= num_nodes or edge.second >= num_nodes) {
+    throw std::runtime_error("Edge refers to a node that does not exist.");
+  }
+}
+
+// The arrays of a graph that owns its memory
+struct OwnedArrays {
+  std::vector<CsrGraph::size_type> offsets;
+  std::vector<NodeId> adjacency;
+};
+
+void build_parallel(std::vector<Edge> const &edges, unsigned const num_threads,
+                    OwnedArrays &arrays) {
+  using size_type = CsrGraph::size_type;
+  std::vector<size_type> &offsets = arrays.offsets;
+  std::vector<NodeId> &adjacency = arrays.adjacency;
+  NodeId const num_nodes = offsets.size() - 1;
+
+  // Count the degrees
+  std::unique_ptr<std::atomic<size_type>[]> counters(
+      new std::atomic<size_type>[num_nodes]);
+  parallel_for_blocks(num_nodes, num_threads,
+                      [&](size_type const begin, size_type const end) {
+                        for (NodeId node_id = begin; node_id < end; ++node_id) {
+                          counters[node_id].store(0, std::memory_order_relaxed);
+                        }
+                      });
+  parallel_for_blocks(
+      edges.size(), num_threads, [&](size_type const begin, size_type const end) {
+        for (size_type edge_idx = begin; edge_idx < end; ++edge_idx) {
+          Edge const &edge = edges[edge_idx];
+          check_edge(edge, num_nodes);
+          counters[edge.first].fetch_add(1, std::memory_order_relaxed);
+          counters[edge.second].fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+
+  // Prefix sum: sum up each block, scan the block sums, then each block
+  size_type const num_blocks =
+      std::max<size_type>(1, std::min<size_type>(4 * num_threads, num_nodes));
+  std::vector<size_type> block_sums(num_blocks + 1, 0);
+  auto block_begin = [&](size_type const block_idx) {
+    return num_nodes * block_idx / num_blocks;
+  };
+  parallel_for(num_blocks, num_threads, [&](size_type const block_idx) {
+    size_type sum = 0;
+    for (NodeId node_id = block_begin(block_idx);
+         node_id < block_begin(block_idx + 1); ++node_id) {
+      sum += counters[node_id].load(std::memory_order_relaxed);
+    }
+    block_sums[block_idx + 1] = sum;
+  });
+  for (size_type block_idx = 0; block_idx < num_blocks; ++block_idx) {
+    block_sums[block_idx + 1] += block_sums[block_idx];
+  }
+  parallel_for(num_blocks, num_threads, [&](size_type const block_idx) {
+    size_type offset = block_sums[block_idx];
+    for (NodeId node_id = block_begin(block_idx);
+         node_id < block_begin(block_idx + 1); ++node_id) {
+      offsets[node_id] = offset;
+      offset += counters[node_id].load(std::memory_order_relaxed);
+      // From now on the counter is the next free position of the node
+      counters[node_id].store(offsets[node_id], std::memory_order_relaxed);
+    }
+  });
+  offsets[num_nodes] = block_sums[num_blocks];
+
+  // Scatter the edge indices. Their order within each adjacency list depends
+  // on the thread schedule ...
+  parallel_for_blocks(
+      edges.size(), num_threads, [&](size_type const begin, size_type const end) {
+        for (size_type edge_idx = begin; edge_idx < end; ++edge_idx) {
+          Edge const &edge = edges[edge_idx];
+          adjacency[counters[edge.first].fetch_add(
+              1, std::memory_order_relaxed)] = edge_idx;
+          adjacency[counters[edge.second].fetch_add(
+              1, std::memory_order_relaxed)] = edge_idx;
+        }
+      });
+  counters.reset();
+
+  // ... so sort them, then replace each edge index by the neighbor
+  parallel_for_blocks(
+      num_nodes, num_threads, [&](size_type const begin, size_type const end) {
+        for (NodeId node_id = begin; node_id < end; ++node_id) {
+          auto const first = adjacency.begin() + offsets[node_id];
+          auto const last = adjacency.begin() + offsets[node_id + 1];
+          std::sort(first, last);
+          for (auto it = first; it != last; ++it) {
+            Edge const &edge = edges[*it];
+            *it = edge.first == node_id ? edge.second : edge.first;
+          }
+        }
+      });
+}
+
+} // namespace
+
+CsrGraph CsrGraph::build_graph(const std::string &filename,
+                               unsigned const num_threads) {
+  DimacsInstance const instance = read_dimacs(filename, num_threads);
+  return CsrGraph(instance.num_nodes, instance.edges, num_threads);
+}
+
+CsrGraph::CsrGraph(NodeId const num_nodes, std::vector<Edge> const &edges,
+                   unsigned const num_threads)
+    : _num_nodes(num_nodes) {
+  auto arrays = std::make_shared<OwnedArrays>();
+  std::vector<size_type> &offsets = arrays->offsets;
+  std::vector<NodeId> &adjacency = arrays->adjacency;
+  offsets.assign(num_nodes + 1, 0);
+  adjacency.resize(2 * edges.size());
+
+  if (num_threads > 1) {
+    build_parallel(edges, num_threads, *arrays);
+  } else {
+    // First pass: count the degrees
+    for (Edge const &edge : edges) {
+      check_edge(edge, num_nodes);
+      ++offsets[edge.first + 1];
+      ++offsets[edge.second + 1];
+    }
+    for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+      offsets[node_id + 1] += offsets[node_id];
+    }
+
+    // Second pass: scatter the neighbors, keeping the order of the edge list
+    std::vector<size_type> positions(offsets.begin(), offsets.end() - 1);
+    for (Edge const &edge : edges) {
+      adjacency[positions[edge.first]++] = edge.second;
+      adjacency[positions[edge.second]++] = edge.first;
+    }
+  }
+
+  _offsets = offsets.data();
+  _adjacency = adjacency.data();
+  _storage = std::move(arrays);
+}
+
+CsrGraph::CsrGraph(std::shared_ptr<void const> storage,
+                   size_type const *offsets, NodeId const *adjacency,
+                   NodeId const num_nodes)
+    : _storage(std::move(storage)), _offsets(offsets), _adjacency(adjacency),
+      _num_nodes(num_nodes) {}
+
+CsrGraph::CsrGraph(Graph const &graph) : _num_nodes(graph.num_nodes()) {
+  auto arrays = std::make_shared<OwnedArrays>();
+  arrays->offsets.assign(graph.num_nodes() + 1, 0);
+  arrays->adjacency.reserve(2 * graph.num_edges());
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    auto const &neighbors = graph.node(node_id).neighbors();
+    arrays->adjacency.insert(arrays->adjacency.end(), neighbors.begin(),
+                             neighbors.end());
+    arrays->offsets[node_id + 1] = arrays->adjacency.size();
+  }
+  _offsets = arrays->offsets.data();
+  _adjacency = arrays->adjacency.data();
+  _storage = std::move(arrays);
+}
+
+std::ostream &operator<<(std::ostream &str, CsrGraph const &graph) {
+  str << "c This encodes a graph in DIMACS format\n"
+      << "p edge " << graph.num_nodes() << " " << graph.num_edges() << "\n";
+
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+      // output each edge only once
+      if (node_id < neighbor_id) {
+        str << "e " << to_dimacs_id(node_id) << " " << to_dimacs_id(neighbor_id)
+            << "\n";
+      }
+    }
+  }
+
+  str << std::flush;
+  return str;
+}
+
+} // namespace ED
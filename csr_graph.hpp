@@ -0,0 +1,149 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+
+/**
+   @file csr_graph.hpp
+
+   @brief This file provides the immutable graph class @c CsrGraph which stores
+all adjacency lists in one array (compressed sparse row format).
+**/
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace ED {
+
+/**
+   @class NeighborRange
+
+   @brief A read-only view of a contiguous range of node ids, used in place of
+@c std::span which is not available in C++17.
+**/
+class NeighborRange {
+public:
+  typedef std::size_t size_type;
+  typedef NodeId const *const_iterator;
+
+  NeighborRange(NodeId const *begin, NodeId const *end)
+      : _begin(begin), _end(end) {}
+
+  const_iterator begin() const { return _begin; }
+  const_iterator end() const { return _end; }
+  size_type size() const { return static_cast<size_type>(_end - _begin); }
+  bool empty() const { return _begin == _end; }
+  NodeId front() const { return *_begin; }
+  NodeId operator[](size_type const idx) const { return _begin[idx]; }
+
+private:
+  NodeId const *_begin;
+  NodeId const *_end;
+};
+
+/**
+   @class CsrGraph
+
+   @brief An immutable undirected graph. The neighbors of node @c i are stored
+in <tt>adjacency[offsets[i]], ..., adjacency[offsets[i+1] - 1]</tt>.
+
+   In contrast to @c Graph, which allocates one neighbor vector per node, a @c
+CsrGraph consists of exactly two arrays, so neighbor scans are sequential memory
+accesses. It offers the same <tt>node(id).neighbors()</tt> interface as @c
+Graph, and the neighbors of each node appear in the same order as if the edges
+had been added to a @c Graph one by one.
+
+   The two arrays are either owned by the graph or live in external memory
+(e.g. a memory-mapped binary graph file) that the graph keeps alive. Since the
+graph is immutable, copies share the arrays.
+**/
+class CsrGraph {
+public:
+  typedef std::size_t size_type;
+
+  /**
+     @class NodeView
+     @brief Lightweight handle returned by @c CsrGraph::node().
+  **/
+  class NodeView {
+  public:
+    /** @return The number of neighbors of this node. **/
+    size_type degree() const { return _neighbors.size(); }
+
+    /** @return The ids of the neighbors of this node. **/
+    NeighborRange neighbors() const { return _neighbors; }
+
+  private:
+    friend class CsrGraph;
+    explicit NodeView(NeighborRange const neighbors) : _neighbors(neighbors) {}
+
+    NeighborRange _neighbors;
+  };
+
+  /**
+     @brief Creates the graph from the given file in DIMACS format, using up to
+  @c num_threads threads for parsing and construction.
+  **/
+  static CsrGraph build_graph(const std::string &filename,
+                              unsigned const num_threads = 1);
+
+  /**
+     @brief Creates the graph with nodes 0, ..., num_nodes - 1 and the given
+  edges in two passes (counting degrees, then scattering the neighbors).
+
+     Throws if an edge is a loop or refers to a node that does not exist.
+
+     With more than one thread, degrees are counted with atomic increments,
+  the prefix sum is computed blockwise and the neighbors are scattered
+  concurrently. Each adjacency list is then sorted by edge index, so the
+  result is identical to the sequential construction.
+  **/
+  CsrGraph(NodeId const num_nodes, std::vector<Edge> const &edges,
+           unsigned const num_threads = 1);
+
+  /** @brief Copies the given graph into CSR format. **/
+  explicit CsrGraph(Graph const &graph);
+
+  /**
+     @brief Wraps existing CSR arrays without copying them. @c offsets must
+  have <tt>num_nodes + 1</tt> entries and @c adjacency <tt>offsets[num_nodes]
+  </tt> entries; @c storage is kept alive as long as the graph (or a copy of
+  it) exists.
+  **/
+  CsrGraph(std::shared_ptr<void const> storage, size_type const *offsets,
+           NodeId const *adjacency, NodeId const num_nodes);
+
+  /** @return The number of nodes in the graph. **/
+  NodeId num_nodes() const { return _num_nodes; }
+
+  /** @return The number of edges in the graph. **/
+  size_type num_edges() const { return _offsets[_num_nodes] / 2; }
+
+  /** @return A view of the node with the given id. **/
+  NodeView node(NodeId const id) const {
+    return NodeView(NeighborRange(_adjacency + _offsets[id],
+                                  _adjacency + _offsets[id + 1]));
+  }
+
+  /** @return The offsets array (with <tt>num_nodes() + 1</tt> entries). **/
+  size_type const *offsets() const { return _offsets; }
+
+  /** @return The adjacency array (with <tt>2 * num_edges()</tt> entries). **/
+  NodeId const *adjacency() const { return _adjacency; }
+
+  /**
+    @brief Prints the graph to the given ostream in DIMACS format.
+  **/
+  friend std::ostream &operator<<(std::ostream &str, CsrGraph const &graph);
+
+private:
+  std::shared_ptr<void const> _storage;
+  size_type const *_offsets;
+  NodeId const *_adjacency;
+  NodeId _num_nodes;
+}; // class CsrGraph
+
+} // namespace ED
+
+#endif /* CSR_GRAPH_HPP */
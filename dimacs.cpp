@@ -0,0 +1,229 @@
+#include "dimacs.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+
+namespace ED {
+
+namespace {
+
+// Chunks smaller than this are not worth a separate task
+std::size_t constexpr min_chunk_size = std::size_t(1) << 20;
+
+bool is_blank(char const c) { return c == ' ' or c == '\t' or c == '\r'; }
+
+char const *skip_blanks(char const *pos, char const *end) {
+  while (pos != end and is_blank(*pos)) {
+    ++pos;
+  }
+  return pos;
+}
+
+char const *skip_line(char const *pos, char const *end) {
+  pos = std::find(pos, end, '\n');
+  return pos == end ? end : pos + 1;
+}
+
+// Parses an unsigned integer preceded by blanks, returns nullptr on failure
+char const *parse_number(char const *pos, char const *end, std::size_t &value) {
+  pos = skip_blanks(pos, end);
+  auto const result = std::from_chars(pos, end, value);
+  if (result.ec != std::errc() or result.ptr == pos) {
+    return nullptr;
+  }
+  return result.ptr;
+}
+
+// Parses the optional signed integer weight at the end of an edge line,
+// returns nullptr on failure. The whole word has to be the number, so that
+// e.g. "3.5" is rejected instead of being read as 3.
+char const *parse_weight(char const *pos, char const *end, Weight &value) {
+  pos = skip_blanks(pos, end);
+  if (pos == end or *pos == '\n') {
+    value = 1;
+    return pos;
+  }
+  auto const result = std::from_chars(pos, end, value);
+  if (result.ec != std::errc() or result.ptr == pos or
+      (result.ptr != end and not is_blank(*result.ptr) and
+       *result.ptr != '\n')) {
+    return nullptr;
+  }
+  return result.ptr;
+}
+
+// Skips a word preceded by blanks
+char const *skip_word(char const *pos, char const *end) {
+  pos = skip_blanks(pos, end);
+  while (pos != end and not is_blank(*pos) and *pos != '\n') {
+    ++pos;
+  }
+  return pos;
+}
+
+std::size_t line_number(char const *data, char const *pos) {
+  return std::count(data, pos, '\n') + 1;
+}
+
+[[noreturn]] void throw_malformed(char const *data, char const *pos,
+                                  std::string const &reason) {
+  throw std::runtime_error("Malformed line " +
+                           std::to_string(line_number(data, pos)) +
+                           " in DIMACS stream: " + reason);
+}
+
+} // namespace
+
+DimacsHeader parse_dimacs_header(char const *data, std::size_t size) {
+  char const *const end = data + size;
+  char const *pos = data;
+  while (pos != end and (*pos == 'c' or *pos == '\n')) {
+    pos = skip_line(pos, end);
+  }
+  if (pos == end) {
+    throw std::runtime_error("Could not find problem line in DIMACS stream.");
+  }
+  if (*pos != 'p') {
+    throw std::runtime_error("Unexpected format of input file.");
+  }
+
+  char const *const line = pos;
+  // Skip "p" and the problem type ("edge")
+  pos = skip_word(skip_word(pos, end), end);
+  std::size_t num_nodes = 0;
+  std::size_t num_edges = 0;
+  pos = parse_number(pos, end, num_nodes);
+  if (pos) {
+    pos = parse_number(pos, end, num_edges);
+  }
+  if (not pos) {
+    throw_malformed(data, line, "expected 'p edge <nodes> <edges>'.");
+  }
+
+  DimacsHeader header;
+  header.num_nodes = num_nodes;
+  header.num_edges = num_edges;
+  header.body_offset = skip_line(pos, end) - data;
+  return header;
+}
+
+void parse_dimacs_edges(char const *data, std::size_t begin, std::size_t end,
+                        DimacsHeader const &header, std::vector<Edge> &edges,
+                        std::vector<Weight> *weights) {
+  char const *pos = data + begin;
+  char const *const stop = data + end;
+  while (pos != stop) {
+    if (*pos != 'e') {
+      pos = skip_line(pos, stop);
+      continue;
+    }
+    char const *const line = pos;
+    DimacsId i = 0;
+    DimacsId j = 0;
+    pos = parse_number(line + 1, stop, i);
+    if (pos) {
+      pos = parse_number(pos, stop, j);
+    }
+    if (not pos) {
+      throw_malformed(data, line, "expected 'e <node> <node>'.");
+    }
+    if (i == 0 or j == 0 or i > header.num_nodes or j > header.num_nodes) {
+      throw_malformed(data, line, "node id out of range.");
+    }
+    if (weights) {
+      Weight weight = 1;
+      pos = parse_weight(pos, stop, weight);
+      if (not pos) {
+        throw_malformed(data, line, "expected 'e <node> <node> [<weight>]'.");
+      }
+      weights->push_back(weight);
+    }
+    edges.emplace_back(from_dimacs_id(i), from_dimacs_id(j));
+    pos = skip_line(pos, stop);
+  }
+}
+
+DimacsInstance read_dimacs(const std::string &filename,
+                           unsigned const num_threads,
+                           bool const with_weights) {
+  return read_dimacs(MappedFile(filename), num_threads, with_weights);
+}
+
+DimacsInstance read_dimacs(MappedFile const &file, unsigned const num_threads,
+                           bool const with_weights) {
+  DimacsHeader const header = parse_dimacs_header(file.data(), file.size());
+
+  DimacsInstance instance;
+  instance.num_nodes = header.num_nodes;
+
+  std::size_t const body_size = file.size() - header.body_offset;
+  std::size_t const num_chunks = std::max<std::size_t>(
+      1, std::min<std::size_t>(4 * std::max(num_threads, 1u),
+                               body_size / min_chunk_size));
+  if (num_threads <= 1 or num_chunks == 1) {
+    instance.edges.reserve(header.num_edges);
+    if (with_weights) {
+      instance.weights.reserve(header.num_edges);
+    }
+    parse_dimacs_edges(file.data(), header.body_offset, file.size(), header,
+                       instance.edges,
+                       with_weights ? &instance.weights : nullptr);
+    return instance;
+  }
+
+  // Split the body into chunks that start at the beginning of a line
+  std::vector<std::size_t> chunk_begins(num_chunks + 1, file.size());
+  chunk_begins[0] = header.body_offset;
+  for (std::size_t chunk_idx = 1; chunk_idx < num_chunks; ++chunk_idx) {
+    std::size_t const guess =
+        header.body_offset + body_size * chunk_idx / num_chunks;
+    chunk_begins[chunk_idx] = std::max(
+        chunk_begins[chunk_idx - 1],
+        static_cast<std::size_t>(skip_line(file.data() + guess,
+                                           file.data() + file.size()) -
+                                 file.data()));
+  }
+
+  // Parse the chunks into local edge lists ...
+  std::vector<std::vector<Edge>> chunk_edges(num_chunks);
+  std::vector<std::vector<Weight>> chunk_weights(num_chunks);
+  parallel_for(num_chunks, num_threads, [&](std::size_t const chunk_idx) {
+    std::size_t const begin = chunk_begins[chunk_idx];
+    std::size_t const end = chunk_begins[chunk_idx + 1];
+    std::size_t const expected_edges =
+        header.num_edges * (end - begin) / std::max<std::size_t>(body_size, 1) +
+        16;
+    chunk_edges[chunk_idx].reserve(expected_edges);
+    if (with_weights) {
+      chunk_weights[chunk_idx].reserve(expected_edges);
+    }
+    parse_dimacs_edges(file.data(), begin, end, header, chunk_edges[chunk_idx],
+                       with_weights ? &chunk_weights[chunk_idx] : nullptr);
+  });
+
+  // ... and concatenate them in file order
+  std::vector<std::size_t> chunk_offsets(num_chunks + 1, 0);
+  for (std::size_t chunk_idx = 0; chunk_idx < num_chunks; ++chunk_idx) {
+    chunk_offsets[chunk_idx + 1] =
+        chunk_offsets[chunk_idx] + chunk_edges[chunk_idx].size();
+  }
+  instance.edges.resize(chunk_offsets.back());
+  if (with_weights) {
+    instance.weights.resize(chunk_offsets.back());
+  }
+  parallel_for(num_chunks, num_threads, [&](std::size_t const chunk_idx) {
+    std::copy(chunk_edges[chunk_idx].begin(), chunk_edges[chunk_idx].end(),
+              instance.edges.begin() + chunk_offsets[chunk_idx]);
+    std::vector<Edge>().swap(chunk_edges[chunk_idx]);
+    std::copy(chunk_weights[chunk_idx].begin(), chunk_weights[chunk_idx].end(),
+              instance.weights.begin() + chunk_offsets[chunk_idx]);
+    std::vector<Weight>().swap(chunk_weights[chunk_idx]);
+  });
+  return instance;
+}
+
+} // namespace ED
@@ -0,0 +1,86 @@
+#ifndef DIMACS_HPP
+#define DIMACS_HPP
+
+/**
+   @file dimacs.hpp
+
+   @brief Fast reading of graphs in DIMACS format.
+
+   The file is memory-mapped and scanned once; integers are parsed with @c
+std::from_chars, and the edge array is reserved from the counts in the problem
+line. Malformed lines are reported with their line number. With several
+threads, the file is split into newline-aligned chunks that are parsed
+concurrently; the resulting edge list is the same as with one thread.
+**/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "mapped_file.hpp"
+
+namespace ED {
+
+/**
+   @brief The contents of a DIMACS file: the number of nodes and the list of
+edges, with node ids already converted to 0-based @c NodeId s.
+**/
+struct DimacsInstance {
+  NodeId num_nodes = 0;
+  std::vector<Edge> edges;
+  //! The weights of @c edges (same order) if they were requested, else empty.
+  std::vector<Weight> weights;
+};
+
+/**
+   @brief The problem line of a DIMACS file.
+**/
+struct DimacsHeader {
+  NodeId num_nodes = 0;
+  std::size_t num_edges = 0;
+  //! Offset of the first byte after the problem line.
+  std::size_t body_offset = 0;
+};
+
+/**
+   @brief Skips leading comment lines and parses the problem line
+<tt>p edge <num_nodes> <num_edges></tt>.
+**/
+DimacsHeader parse_dimacs_header(char const *data, std::size_t size);
+
+/**
+   @brief Appends the edges of all <tt>e</tt> lines in <tt>data[begin, end)</tt>
+to @c edges. Other lines are ignored.
+
+   If @c weights is not null, the optional third number of every edge line
+<tt>e <node> <node> <weight></tt> is appended to it (1 if it is missing);
+otherwise anything after the two nodes is ignored.
+
+   @c begin must be the start of a line. Throws if an edge line is malformed or
+refers to a node that does not exist; the line number in the message is counted
+from @c data.
+**/
+void parse_dimacs_edges(char const *data, std::size_t begin, std::size_t end,
+                        DimacsHeader const &header, std::vector<Edge> &edges,
+                        std::vector<Weight> *weights = nullptr);
+
+/**
+   @brief Reads the given file in DIMACS format using up to @c num_threads
+threads. Edge weights are only read if @c with_weights is set.
+**/
+DimacsInstance read_dimacs(const std::string &filename,
+                           unsigned const num_threads = 1,
+                           bool const with_weights = false);
+
+/**
+   @brief Like the above, for a file that is already open (e.g. after looking
+at its first bytes, which cannot be read twice from a pipe).
+**/
+DimacsInstance read_dimacs(MappedFile const &file,
+                           unsigned const num_threads = 1,
+                           bool const with_weights = false);
+
+} // namespace ED
+
+#endif /* DIMACS_HPP */
@@ -0,0 +1,231 @@
+#include "dynamic_matching.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+
+namespace ED {
+
+namespace {
+
+Edge const no_bridge(invalid_node_id, invalid_node_id);
+
+bool are_adjacent(Graph const &graph, NodeId const node1_id,
+                  NodeId const node2_id) {
+  std::vector<NodeId> const &neighbors = graph.node(node1_id).neighbors();
+  return std::find(neighbors.begin(), neighbors.end(), node2_id) !=
+         neighbors.end();
+}
+
+} // namespace
+
+DynamicMatching::DynamicMatching(Graph graph, MatchingOptions const &options)
+    : _graph(std::move(graph)),
+      _matching(compute_maximum_cardinality_matching(_graph, options)),
+      _labels(_graph.num_nodes(), UNLABELED),
+      _parents(_graph.num_nodes(), invalid_node_id),
+      _bridges(_graph.num_nodes(), no_bridge), _blossoms(_graph.num_nodes()),
+      _marked(_graph.num_nodes(), false) {}
+
+void DynamicMatching::insert_edge(NodeId node1_id, NodeId node2_id) {
+  _graph.add_edge(node1_id, node2_id);
+  if (_matching.is_exposed(node1_id) and _matching.is_exposed(node2_id)) {
+    _matching.match(node1_id, node2_id);
+    return;
+  }
+  if (_matching.is_exposed(node2_id)) {
+    std::swap(node1_id, node2_id);
+  }
+  if (not _matching.is_exposed(node1_id)) {
+    // An augmenting path through the new edge continues with the matching
+    // edge of node1_id; exposing node1_id keeps the matching size
+    NodeId const mate_id = _matching.mate(node1_id);
+    _matching.unmatch(node1_id);
+    if (not augment_from(mate_id, node1_id, invalid_node_id)) {
+      _matching.match(node1_id, mate_id);
+      return;
+    }
+  }
+  // Now an augmenting path starts with node1_id, node2_id and its mate, so
+  // the rest of it avoids both and augments from the mate once node2_id is
+  // unmatched
+  NodeId const mate_id = _matching.mate(node2_id);
+  _matching.unmatch(node2_id);
+  if (augment_from(mate_id, node1_id, node2_id)) {
+    _matching.match(node1_id, node2_id);
+  } else {
+    _matching.match(node2_id, mate_id);
+  }
+}
+
+bool DynamicMatching::delete_edge(NodeId const node1_id,
+                                  NodeId const node2_id) {
+  if (not _graph.remove_edge(node1_id, node2_id)) {
+    return false;
+  }
+  if (_matching.mate(node1_id) == node2_id and
+      not are_adjacent(_graph, node1_id, node2_id)) {
+    _matching.unmatch(node1_id);
+    if (not augment_from(node1_id, invalid_node_id, invalid_node_id)) {
+      augment_from(node2_id, invalid_node_id, invalid_node_id);
+    }
+  }
+  return true;
+}
+
+void DynamicMatching::apply_updates(std::vector<Edge> const &insertions,
+                                    std::vector<Edge> const &deletions) {
+  for (Edge const &edge : deletions) {
+    delete_edge(edge.first, edge.second);
+  }
+  for (Edge const &edge : insertions) {
+    insert_edge(edge.first, edge.second);
+  }
+}
+
+bool DynamicMatching::augment_from(NodeId const root, NodeId const excluded1,
+                                   NodeId const excluded2) {
+  for (NodeId const node_id : _labeled) {
+    _labels[node_id] = UNLABELED;
+    _bridges[node_id] = no_bridge;
+  }
+  _labeled.clear();
+  _queue.clear();
+  _blossoms.begin_tree();
+
+  // Excluded nodes are never entered
+  for (NodeId const node_id : {excluded1, excluded2}) {
+    if (node_id != invalid_node_id) {
+      set_label(node_id, EXCLUDED);
+    }
+  }
+  _root = root;
+  set_label(root, EVEN);
+  _queue.push_back(root);
+  for (std::size_t queue_idx = 0; queue_idx < _queue.size(); ++queue_idx) {
+    NodeId const node_id = _queue[queue_idx];
+    for (NodeId const neighbor_id : _graph.node(node_id).neighbors()) {
+      if (_labels[neighbor_id] == UNLABELED) {
+        NodeId const mate_id = _matching.mate(neighbor_id);
+        if (mate_id == invalid_node_id) {
+          _path.clear();
+          _path.push_back(neighbor_id);
+          append_path(node_id, root, _path);
+          _matching.augment(_path);
+          return true;
+        }
+        set_label(neighbor_id, ODD);
+        _parents[neighbor_id] = node_id;
+        set_label(mate_id, EVEN);
+        _queue.push_back(mate_id);
+      } else if (_labels[neighbor_id] == EVEN and
+                 _blossoms.base(node_id) != _blossoms.base(neighbor_id)) {
+        NodeId const common_base = find_common_base(node_id, neighbor_id);
+        shrink_blossom_path(node_id, neighbor_id, common_base);
+        shrink_blossom_path(neighbor_id, node_id, common_base);
+      }
+    }
+  }
+  return false;
+}
+
+void DynamicMatching::set_label(NodeId const node_id, Label const label) {
+  if (_labels[node_id] == UNLABELED) {
+    _labeled.push_back(node_id);
+  }
+  _labels[node_id] = label;
+}
+
+// Walks up from both nodes in turn until one walk meets a base the other one
+// has passed, so the cost is proportional to the new blossom
+NodeId DynamicMatching::find_common_base(NodeId const node1_id,
+                                         NodeId const node2_id) {
+  NodeId bases[2] = {_blossoms.base(node1_id), _blossoms.base(node2_id)};
+  NodeId common_base = invalid_node_id;
+  for (unsigned side = 0; common_base == invalid_node_id; side = 1 - side) {
+    NodeId &base = bases[side];
+    if (base == invalid_node_id) {
+      continue;
+    }
+    if (_marked[base]) {
+      common_base = base;
+      break;
+    }
+    _marked[base] = true;
+    _marked_nodes.push_back(base);
+    base = base == _root
+               ? invalid_node_id
+               : _blossoms.base(_parents[_matching.mate(base)]);
+  }
+  for (NodeId const node_id : _marked_nodes) {
+    _marked[node_id] = false;
+  }
+  _marked_nodes.clear();
+  return common_base;
+}
+
+// Shrinks the bases from node_id up to common_base into the blossom of
+// common_base; the odd nodes on the way become even and remember the edge
+// {node_id, other_id} that closed the blossom
+void DynamicMatching::shrink_blossom_path(NodeId const node_id,
+                                          NodeId const other_id,
+                                          NodeId const common_base) {
+  NodeId base = _blossoms.base(node_id);
+  while (base != common_base) {
+    NodeId const odd_id = _matching.mate(base);
+    NodeId const next_base = _blossoms.base(_parents[odd_id]);
+    _bridges[odd_id] = Edge(node_id, other_id);
+    set_label(odd_id, EVEN);
+    _queue.push_back(odd_id);
+    _blossoms.unite(base, common_base);
+    _blossoms.unite(odd_id, common_base);
+    _blossoms.set_blossom(common_base, common_base, 0);
+    base = next_base;
+  }
+}
+
+// Appends the even alternating path from the even node node_id to target_id
+// (both included), which starts with the matching edge of node_id. An odd node
+// that was shrunk into a blossom reaches target_id the other way round the
+// blossom: back to the bridge, across it, and on from its other end. The part
+// up to the bridge is a path of the same kind in reverse order, so nested
+// bridges are expanded with an explicit stack of tasks instead of recursion.
+void DynamicMatching::append_path(NodeId const node_id,
+                                  NodeId const target_id,
+                                  std::vector<NodeId> &path) {
+  _path_tasks.assign(1, PathTask{node_id, target_id, false});
+  while (not _path_tasks.empty()) {
+    PathTask const task = _path_tasks.back();
+    _path_tasks.pop_back();
+    if (task.node_id == task.target_id) {
+      path.push_back(task.node_id);
+      continue;
+    }
+    NodeId const mate_id = _matching.mate(task.node_id);
+    Edge const &bridge = _bridges[task.node_id];
+    // The tasks are pushed such that the next one to be emitted is on top
+    if (not task.reversed) {
+      path.push_back(task.node_id);
+      if (bridge == no_bridge) {
+        path.push_back(mate_id);
+        _path_tasks.push_back(
+            PathTask{_parents[mate_id], task.target_id, false});
+      } else {
+        _path_tasks.push_back(PathTask{bridge.second, task.target_id, false});
+        _path_tasks.push_back(PathTask{bridge.first, mate_id, true});
+      }
+    } else {
+      _path_tasks.push_back(PathTask{task.node_id, task.node_id, false});
+      if (bridge == no_bridge) {
+        _path_tasks.push_back(PathTask{mate_id, mate_id, false});
+        _path_tasks.push_back(
+            PathTask{_parents[mate_id], task.target_id, true});
+      } else {
+        _path_tasks.push_back(PathTask{bridge.first, mate_id, false});
+        _path_tasks.push_back(PathTask{bridge.second, task.target_id, true});
+      }
+    }
+  }
+}
+
+} // namespace ED
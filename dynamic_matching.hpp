@@ -0,0 +1,115 @@
+#ifndef DYNAMIC_MATCHING_HPP
+#define DYNAMIC_MATCHING_HPP
+
+/**
+   @file dynamic_matching.hpp
+
+   @brief A maximum matching that is kept maximum while edges are inserted and
+deleted, without solving the changed graph from scratch.
+**/
+
+#include <cstdint>
+#include <vector>
+
+#include "blossom_union_find.hpp"
+#include "graph.hpp"
+#include "matching.hpp"
+#include "maximum_cardinality_matching.hpp"
+
+namespace ED {
+
+/**
+   @class DynamicMatching
+
+   @brief Owns a graph and a maximum matching of it. After every update, the
+matching is repaired by at most two searches for an augmenting path, rooted at
+the endpoints of the changed edge:
+
+   - Inserting an edge raises the maximum by at most one, and only along an
+     augmenting path through the new edge. If both endpoints are matched, one
+     of them is first exposed by an alternating path from its mate that
+     avoids it, which exists exactly if such an augmenting path does. The
+     path then leaves the exposed endpoint over the new edge and the matching
+     edge of the other one, so the search starts behind both.
+   - Deleting a matching edge exposes both endpoints. Since the matching was
+     maximum, every augmenting path ends in one of them.
+   - Deleting any other edge keeps the matching maximum.
+
+   A search only labels the nodes of one alternating tree and resets only
+those afterwards, so an update costs time proportional to the part of the
+graph the tree reaches (the whole component in the worst case), not to the
+size of the graph.
+**/
+class DynamicMatching {
+public:
+  /** @brief Takes over @c graph and computes a maximum matching of it. **/
+  explicit DynamicMatching(Graph graph,
+                           MatchingOptions const &options = MatchingOptions());
+
+  Graph const &graph() const { return _graph; }
+  Matching const &matching() const { return _matching; }
+
+  /**
+     @brief Adds the edge <tt>{node1_id, node2_id}</tt> (a parallel edge if it
+  already exists). Throws for loops and invalid node ids.
+  **/
+  void insert_edge(NodeId const node1_id, NodeId const node2_id);
+
+  /**
+     @brief Removes one copy of the edge <tt>{node1_id, node2_id}</tt>.
+     @return Whether the edge existed.
+  **/
+  bool delete_edge(NodeId const node1_id, NodeId const node2_id);
+
+  /**
+     @brief Applies all @c deletions, then all @c insertions, repairing the
+  matching after each of them.
+  **/
+  void apply_updates(std::vector<Edge> const &insertions,
+                     std::vector<Edge> const &deletions);
+
+private:
+  enum Label : std::uint8_t { UNLABELED, EVEN, ODD, EXCLUDED };
+
+  // The path from node_id to target_id as built by append_path, in reverse
+  // order if reversed is set
+  struct PathTask {
+    NodeId node_id;
+    NodeId target_id;
+    bool reversed;
+  };
+
+  // Grows an alternating tree from the exposed node root, without entering
+  // the excluded nodes (invalid_node_id for none), and augments along the
+  // first augmenting path it finds
+  bool augment_from(NodeId const root, NodeId const excluded1,
+                    NodeId const excluded2);
+  void set_label(NodeId const node_id, Label const label);
+  NodeId find_common_base(NodeId const node1_id, NodeId const node2_id);
+  void shrink_blossom_path(NodeId const node_id, NodeId const other_id,
+                           NodeId const common_base);
+  void append_path(NodeId const node_id, NodeId const target_id,
+                   std::vector<NodeId> &path);
+
+  Graph _graph;
+  Matching _matching;
+
+  // State of the current search; only the nodes in _labeled have a label,
+  // a parent (odd nodes) or a bridge (odd nodes shrunk into a blossom, with
+  // the edge that closed the blossom, seen from the node's side)
+  NodeId _root = invalid_node_id;
+  std::vector<Label> _labels;
+  std::vector<NodeId> _parents;
+  std::vector<Edge> _bridges;
+  BlossomUnionFind _blossoms;
+  std::vector<NodeId> _labeled;
+  std::vector<NodeId> _queue;
+  std::vector<bool> _marked;
+  std::vector<NodeId> _marked_nodes;
+  std::vector<NodeId> _path;
+  std::vector<PathTask> _path_tasks;
+}; // class DynamicMatching
+
+} // namespace ED
+
+#endif /* DYNAMIC_MATCHING_HPP */
@@ -0,0 +1,168 @@
+#include "generators.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace ED {
+
+namespace {
+
+// Renames the nodes by a random permutation, so that the node order tells
+// nothing about the structure
+void permute_nodes(GeneratedGraph &graph, std::mt19937_64 &random) {
+  std::vector<NodeId> new_ids(graph.num_nodes);
+  for (NodeId node_id = 0; node_id < graph.num_nodes; ++node_id) {
+    new_ids[node_id] = node_id;
+  }
+  for (NodeId idx = graph.num_nodes; idx > 1; --idx) {
+    std::swap(new_ids[idx - 1], new_ids[random() % idx]);
+  }
+  for (Edge &edge : graph.edges) {
+    edge = {new_ids[edge.first], new_ids[edge.second]};
+  }
+}
+
+} // namespace
+
+GeneratedGraph generate_erdos_renyi(NodeId const num_nodes,
+                                    double const average_degree,
+                                    std::uint64_t const seed) {
+  GeneratedGraph graph;
+  graph.num_nodes = num_nodes;
+  if (num_nodes < 2) {
+    return graph;
+  }
+  std::mt19937_64 random(seed);
+  std::size_t const num_edges = num_nodes * average_degree / 2;
+  graph.edges.reserve(num_edges);
+  while (graph.edges.size() < num_edges) {
+    NodeId const first = random() % num_nodes;
+    NodeId const second = random() % num_nodes;
+    if (first != second) {
+      graph.edges.emplace_back(first, second);
+    }
+  }
+  permute_nodes(graph, random);
+  return graph;
+}
+
+GeneratedGraph generate_random_regular(NodeId const num_nodes,
+                                       unsigned const degree,
+                                       std::uint64_t const seed) {
+  std::mt19937_64 random(seed);
+  std::vector<NodeId> endpoints;
+  endpoints.reserve(std::size_t(num_nodes) * degree);
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    endpoints.insert(endpoints.end(), degree, node_id);
+  }
+  for (std::size_t idx = endpoints.size(); idx > 1; --idx) {
+    std::swap(endpoints[idx - 1], endpoints[random() % idx]);
+  }
+  GeneratedGraph graph;
+  graph.num_nodes = num_nodes;
+  for (std::size_t idx = 0; idx + 1 < endpoints.size(); idx += 2) {
+    if (endpoints[idx] != endpoints[idx + 1]) {
+      graph.edges.emplace_back(endpoints[idx], endpoints[idx + 1]);
+    }
+  }
+  permute_nodes(graph, random);
+  return graph;
+}
+
+GeneratedGraph generate_grid(NodeId const width, NodeId const height,
+                             std::uint64_t const seed) {
+  GeneratedGraph graph;
+  graph.num_nodes = width * height;
+  for (NodeId row = 0; row < height; ++row) {
+    for (NodeId column = 0; column < width; ++column) {
+      NodeId const node_id = row * width + column;
+      if (column + 1 < width) {
+        graph.edges.emplace_back(node_id, node_id + 1);
+      }
+      if (row + 1 < height) {
+        graph.edges.emplace_back(node_id, node_id + width);
+      }
+    }
+  }
+  std::mt19937_64 random(seed);
+  permute_nodes(graph, random);
+  return graph;
+}
+
+GeneratedGraph generate_bipartite(NodeId const num_left, NodeId const num_right,
+                                  std::size_t const num_edges,
+                                  std::uint64_t const seed) {
+  GeneratedGraph graph;
+  graph.num_nodes = num_left + num_right;
+  if (num_left == 0 or num_right == 0) {
+    return graph;
+  }
+  std::mt19937_64 random(seed);
+  graph.edges.reserve(num_edges);
+  for (std::size_t edge_idx = 0; edge_idx < num_edges; ++edge_idx) {
+    NodeId const left = random() % num_left;
+    graph.edges.emplace_back(left, num_left + random() % num_right);
+  }
+  permute_nodes(graph, random);
+  return graph;
+}
+
+GeneratedGraph generate_power_law(NodeId const num_nodes,
+                                  unsigned const edges_per_node,
+                                  std::uint64_t const seed) {
+  GeneratedGraph graph;
+  graph.num_nodes = num_nodes;
+  std::mt19937_64 random(seed);
+  // Every edge adds both endpoints, so a uniform entry is a node chosen with
+  // probability proportional to its degree
+  std::vector<NodeId> endpoints;
+  NodeId const num_initial = std::min<NodeId>(num_nodes, edges_per_node + 1);
+  for (NodeId first = 0; first < num_initial; ++first) {
+    for (NodeId second = first + 1; second < num_initial; ++second) {
+      graph.edges.emplace_back(first, second);
+      endpoints.push_back(first);
+      endpoints.push_back(second);
+    }
+  }
+  for (NodeId node_id = num_initial; node_id < num_nodes; ++node_id) {
+    std::size_t const num_endpoints = endpoints.size();
+    for (unsigned edge_idx = 0; edge_idx < edges_per_node; ++edge_idx) {
+      NodeId const neighbor_id = endpoints[random() % num_endpoints];
+      graph.edges.emplace_back(node_id, neighbor_id);
+      endpoints.push_back(node_id);
+      endpoints.push_back(neighbor_id);
+    }
+  }
+  permute_nodes(graph, random);
+  return graph;
+}
+
+GeneratedGraph generate_odd_cycle_chain(NodeId const num_nodes,
+                                        unsigned const cycle_length,
+                                        std::uint64_t const seed) {
+  if (cycle_length < 3 or cycle_length % 2 == 0) {
+    throw std::runtime_error("Cycle length must be odd and at least 3.");
+  }
+  NodeId const num_cycles = num_nodes / cycle_length;
+  GeneratedGraph graph;
+  graph.num_nodes = num_cycles * cycle_length;
+  std::mt19937_64 random(seed);
+  for (NodeId cycle_idx = 0; cycle_idx < num_cycles; ++cycle_idx) {
+    NodeId const first_id = cycle_idx * cycle_length;
+    NodeId const next_first_id = (cycle_idx + 1) % num_cycles * cycle_length;
+    for (NodeId idx = 0; idx < cycle_length; ++idx) {
+      graph.edges.emplace_back(first_id + idx,
+                               first_id + (idx + 1) % cycle_length);
+      if (num_cycles > 1) {
+        graph.edges.emplace_back(first_id + idx,
+                                 next_first_id + random() % cycle_length);
+      }
+    }
+  }
+  permute_nodes(graph, random);
+  return graph;
+}
+
+} // namespace ED
@@ -0,0 +1,81 @@
+#ifndef GENERATORS_HPP
+#define GENERATORS_HPP
+
+/**
+   @file generators.hpp
+
+   @brief Seeded generators of synthetic graph families, used by the benchmark
+(bench.cpp).
+
+   All generators only use @c std::mt19937_64 directly (no distributions or
+@c std::shuffle), so an instance depends on the parameters and the seed only,
+not on the standard library. The node ids are randomly permuted, so that the
+node order tells nothing about the structure, and parallel edges may occur.
+**/
+
+#include <cstdint>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace ED {
+
+//! A graph given by its number of nodes and its edge list.
+struct GeneratedGraph {
+  NodeId num_nodes = 0;
+  std::vector<Edge> edges;
+};
+
+/**
+   @brief Erdos-Renyi graph with @c num_nodes nodes and <tt>num_nodes *
+average_degree / 2</tt> edges between uniformly random pairs of distinct nodes.
+**/
+GeneratedGraph generate_erdos_renyi(NodeId const num_nodes,
+                                    double const average_degree,
+                                    std::uint64_t const seed);
+
+/**
+   @brief Random graph in which (almost) every node has degree @c degree, from
+the configuration model: the endpoint copies are paired at random and loops are
+dropped.
+**/
+GeneratedGraph generate_random_regular(NodeId const num_nodes,
+                                       unsigned const degree,
+                                       std::uint64_t const seed);
+
+/** @brief The @c width by @c height grid graph. **/
+GeneratedGraph generate_grid(NodeId const width, NodeId const height,
+                             std::uint64_t const seed);
+
+/**
+   @brief Random bipartite graph: @c num_edges edges, each between a uniformly
+random node of the first @c num_left nodes and one of the other @c num_right
+nodes (before the permutation).
+**/
+GeneratedGraph generate_bipartite(NodeId const num_left, NodeId const num_right,
+                                  std::size_t const num_edges,
+                                  std::uint64_t const seed);
+
+/**
+   @brief Preferential attachment (Barabasi-Albert): every new node is joined
+to @c edges_per_node earlier nodes, chosen with probability proportional to
+their degree, so the degrees follow a power law.
+**/
+GeneratedGraph generate_power_law(NodeId const num_nodes,
+                                  unsigned const edges_per_node,
+                                  std::uint64_t const seed);
+
+/**
+   @brief Blossom-heavy instance: <tt>num_nodes / cycle_length</tt> cycles of
+the odd length @c cycle_length in a row, where every node is also joined to a
+random node of the next cycle (the last cycle to the first one). Every odd
+cycle can become a blossom, and since no node has degree below 3, the
+reductions of kernel.hpp do not apply.
+**/
+GeneratedGraph generate_odd_cycle_chain(NodeId const num_nodes,
+                                        unsigned const cycle_length,
+                                        std::uint64_t const seed);
+
+} // namespace ED
+
+#endif /* GENERATORS_HPP */
@@ -1,10 +1,11 @@
 #include "graph.hpp" // always include corresponding header first
 
-#include <fstream>
+#include <algorithm>
 #include <iostream>
-#include <sstream>
 #include <stdexcept>
 
+#include "dimacs.hpp"
+
 namespace ED {
 /////////////////////////////////////////////
 //! \c Node definitions
@@ -12,48 +13,26 @@ namespace ED {
 
 void Node::add_neighbor(NodeId const id) { _neighbors.push_back(id); }
 
+bool Node::remove_neighbor(NodeId const id) {
+  auto const it = std::find(_neighbors.begin(), _neighbors.end(), id);
+  if (it == _neighbors.end()) {
+    return false;
+  }
+  *it = _neighbors.back();
+  _neighbors.pop_back();
+  return true;
+}
+
 /////////////////////////////////////////////
 //! \c Graph definitions
 /////////////////////////////////////////////
 
 Graph Graph::build_graph(const std::string &filename) {
-  std::ifstream ifs(filename);
-  if (!ifs.is_open()) {
-    throw std::runtime_error("Could not open input file.");
-  }
-
-  std::string line;
+  DimacsInstance const instance = read_dimacs(filename);
 
-  do {
-    if (!std::getline(ifs, line)) {
-      throw std::runtime_error("Could not find problem line in DIMACS stream.");
-    }
-  } while (line[0] == 'c');
-
-  int num_nodes = 0;
-  int num_edges = 0;
-
-  if (line[0] == 'p') {
-    std::stringstream stream;
-    stream << line;
-    std::string str;
-    stream >> str >> str >> num_nodes >> num_edges;
-  } else {
-    throw std::runtime_error("Unexpected format of input file.");
-  }
-
-  Graph graph(num_nodes);
-  while (std::getline(ifs, line)) {
-    if (line.empty() or line[0] != 'e') {
-      continue;
-    }
-    std::stringstream stream;
-    stream << line;
-    char c;
-    DimacsId i;
-    DimacsId j;
-    stream >> c >> i >> j;
-    graph.add_edge(from_dimacs_id(i), from_dimacs_id(j));
+  Graph graph(instance.num_nodes);
+  for (Edge const &edge : instance.edges) {
+    graph.add_edge(edge.first, edge.second);
   }
 
   return graph;
@@ -78,6 +57,15 @@ void Graph::add_edge(NodeId node1_id, NodeId node2_id) {
   ++_num_edges;
 }
 
+bool Graph::remove_edge(NodeId const node1_id, NodeId const node2_id) {
+  if (not _nodes.at(node1_id).remove_neighbor(node2_id)) {
+    return false;
+  }
+  _nodes.at(node2_id).remove_neighbor(node1_id);
+  --_num_edges;
+  return true;
+}
+
 std::ostream &operator<<(std::ostream &str, Graph const &graph) {
   str << "c This encodes a graph in DIMACS format\n"
       << "p edge " << graph.num_nodes() << " " << graph.num_edges() << "\n";
@@ -9,8 +9,11 @@ undirected graphs.
 **/
 
 #include <cstddef> // std::size_t
+#include <cstdint>
 #include <iosfwd>  // std::ostream fwd declare
 #include <limits>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace ED // for Edmonds
@@ -32,6 +35,12 @@ using DimacsId = size_type;
 NodeId constexpr invalid_node_id = std::numeric_limits<NodeId>::max();
 DimacsId constexpr invalid_dimacs_id = std::numeric_limits<DimacsId>::max();
 
+//! An undirected edge given by the ids of its two end nodes.
+using Edge = std::pair<NodeId, NodeId>;
+
+//! Integral edge weight, used by the weighted matching code only.
+using Weight = std::int64_t;
+
 /**
    Nodes in DIMACS files are counted from 1, but here we count them from 0 so
 they match their std::vector indices. These two trivial functions should help
@@ -76,6 +85,13 @@ private:
   **/
   void add_neighbor(NodeId const id);
 
+  /**
+     @brief Removes one occurrence of @c id from the list of neighbors, which
+  changes the order of the remaining neighbors.
+     @return Whether @c id was a neighbor.
+  **/
+  bool remove_neighbor(NodeId const id);
+
   std::vector<NodeId> _neighbors;
 }; // class Node
 
@@ -135,6 +151,13 @@ public:
   **/
   void add_edge(NodeId node1_id, NodeId node2_id);
 
+  /**
+     @brief Removes one copy of the edge <tt> {node1_id, node2_id} </tt> in
+  O(degree) time.
+     @return Whether the edge existed.
+  **/
+  bool remove_edge(NodeId const node1_id, NodeId const node2_id);
+
   /**
     @brief Prints the graph to the given ostream in DIMACS format.
   **/
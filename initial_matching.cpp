@@ -0,0 +1,306 @@
+#include "initial_matching.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <initializer_list>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace ED {
+
+namespace {
+
+void greedy(CsrGraph const &graph, Matching &matching) {
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (matching.is_exposed(node_id)) {
+      for (NodeId neighbor_id : graph.node(node_id).neighbors()) {
+        if (matching.is_exposed(neighbor_id)) {
+          matching.match(node_id, neighbor_id);
+          break; // Do not add more edges incident to this node!
+        }
+      }
+    }
+  }
+}
+
+// Number of exposed neighbors of every exposed node (with multiplicity)
+std::vector<NodeId> exposed_degrees(CsrGraph const &graph,
+                                    Matching const &matching) {
+  std::vector<NodeId> degrees(graph.num_nodes(), 0);
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (matching.is_exposed(node_id)) {
+      for (NodeId neighbor_id : graph.node(node_id).neighbors()) {
+        degrees[node_id] += matching.is_exposed(neighbor_id);
+      }
+    }
+  }
+  return degrees;
+}
+
+// Matches the two nodes and decrements the exposed degrees of their exposed
+// neighbors, calling on_decrement(neighbor_id) for each of them
+template <typename OnDecrement>
+void match_nodes(CsrGraph const &graph, Matching &matching,
+                 std::vector<NodeId> &degrees, NodeId const a, NodeId const b,
+                 OnDecrement on_decrement) {
+  matching.match(a, b);
+  for (NodeId const node_id : {a, b}) {
+    for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+      if (matching.is_exposed(neighbor_id)) {
+        --degrees[neighbor_id];
+        on_decrement(neighbor_id);
+      }
+    }
+  }
+}
+
+void min_degree(CsrGraph const &graph, Matching &matching) {
+  std::vector<NodeId> degrees = exposed_degrees(graph, matching);
+  NodeId const max_degree =
+      degrees.empty() ? 0 : *std::max_element(degrees.begin(), degrees.end());
+
+  // Bucket queue with lazy deletion: a node is pushed again whenever its
+  // degree drops, outdated entries are skipped when popped.
+  std::vector<std::vector<NodeId>> buckets(max_degree + 1);
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (degrees[node_id] > 0) {
+      buckets[degrees[node_id]].push_back(node_id);
+    }
+  }
+
+  NodeId current = 1;
+  auto const on_decrement = [&](NodeId const node_id) {
+    if (degrees[node_id] > 0) {
+      buckets[degrees[node_id]].push_back(node_id);
+      current = std::min(current, degrees[node_id]);
+    }
+  };
+
+  while (true) {
+    while (current <= max_degree and buckets[current].empty()) {
+      ++current;
+    }
+    if (current > max_degree) {
+      break;
+    }
+    NodeId const node_id = buckets[current].back();
+    buckets[current].pop_back();
+    if (not matching.is_exposed(node_id) or degrees[node_id] != current) {
+      continue;
+    }
+
+    NodeId best_id = invalid_node_id;
+    for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+      if (matching.is_exposed(neighbor_id) and
+          (best_id == invalid_node_id or
+           degrees[neighbor_id] < degrees[best_id])) {
+        best_id = neighbor_id;
+      }
+    }
+    match_nodes(graph, matching, degrees, node_id, best_id, on_decrement);
+  }
+}
+
+void karp_sipser(CsrGraph const &graph, Matching &matching,
+                 std::uint64_t const seed) {
+  std::vector<NodeId> degrees = exposed_degrees(graph, matching);
+  std::vector<NodeId> degree_one;
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (degrees[node_id] == 1) {
+      degree_one.push_back(node_id);
+    }
+  }
+  auto const on_decrement = [&](NodeId const node_id) {
+    if (degrees[node_id] == 1) {
+      degree_one.push_back(node_id);
+    }
+  };
+
+  // The random choices are made by hand instead of with std::shuffle and
+  // std::uniform_int_distribution, whose results differ between standard
+  // libraries.
+  std::mt19937_64 random(seed);
+  std::vector<NodeId> order(graph.num_nodes());
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    order[node_id] = node_id;
+  }
+  for (NodeId idx = graph.num_nodes(); idx > 1; --idx) {
+    std::swap(order[idx - 1], order[random() % idx]);
+  }
+
+  NodeId next = 0;
+  while (true) {
+    // Matching a node of degree one to its only neighbor is always optimal
+    while (not degree_one.empty()) {
+      NodeId const node_id = degree_one.back();
+      degree_one.pop_back();
+      if (not matching.is_exposed(node_id) or degrees[node_id] == 0) {
+        continue;
+      }
+      for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+        if (matching.is_exposed(neighbor_id)) {
+          match_nodes(graph, matching, degrees, node_id, neighbor_id,
+                      on_decrement);
+          break;
+        }
+      }
+    }
+
+    while (next < order.size() and (not matching.is_exposed(order[next]) or
+                                    degrees[order[next]] == 0)) {
+      ++next;
+    }
+    if (next == order.size()) {
+      break;
+    }
+
+    // Otherwise match a random node to a random exposed neighbor
+    NodeId const node_id = order[next];
+    NodeId skip = random() % degrees[node_id];
+    for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+      if (matching.is_exposed(neighbor_id) and skip-- == 0) {
+        match_nodes(graph, matching, degrees, node_id, neighbor_id,
+                    on_decrement);
+        break;
+      }
+    }
+  }
+}
+
+std::uint64_t mix(std::uint64_t value) {
+  // splitmix64 finalizer
+  value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31);
+}
+
+std::uint64_t edge_priority(std::uint64_t const seed, NodeId const a,
+                            NodeId const b) {
+  return mix(mix(seed ^ std::min(a, b)) ^ std::max(a, b));
+}
+
+enum MatchState : std::uint8_t { EXPOSED, MATCHED_BEFORE, MATCHED_NOW };
+
+// Key of an edge in the total order used by locally_dominant: edges are
+// ordered by priority, and ties are broken by the (min id, max id) pair, which
+// both endpoints of an edge agree on
+std::tuple<std::uint64_t, NodeId, NodeId>
+edge_key(std::uint64_t const seed, NodeId const a, NodeId const b) {
+  return std::make_tuple(edge_priority(seed, a, b), std::min(a, b),
+                         std::max(a, b));
+}
+
+// Neighbor connected by the exposed edge with maximum key
+NodeId heaviest_exposed_neighbor(CsrGraph const &graph,
+                                 std::vector<std::uint8_t> const &states,
+                                 std::uint64_t const seed,
+                                 NodeId const node_id) {
+  NodeId best_id = invalid_node_id;
+  std::tuple<std::uint64_t, NodeId, NodeId> best_key;
+  for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+    if (states[neighbor_id] != EXPOSED) {
+      continue;
+    }
+    auto const key = edge_key(seed, node_id, neighbor_id);
+    if (best_id == invalid_node_id or key > best_key) {
+      best_id = neighbor_id;
+      best_key = key;
+    }
+  }
+  return best_id;
+}
+
+// Every exposed node points to its heaviest exposed neighbor, and nodes that
+// point to each other are matched. Rounds alternate between matching mutual
+// pairs and recomputing the pointers to nodes that got matched. The result is
+// the greedy matching in order of decreasing priority, so it does not depend
+// on the number of threads, and no atomics are needed since mutual pairs are
+// disjoint.
+void locally_dominant(CsrGraph const &graph, Matching &matching,
+                      std::uint64_t const seed, unsigned const num_threads) {
+  std::vector<std::uint8_t> states(graph.num_nodes());
+  std::vector<NodeId> active;
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    states[node_id] = matching.is_exposed(node_id) ? EXPOSED : MATCHED_BEFORE;
+    if (matching.is_exposed(node_id) and graph.node(node_id).degree() > 0) {
+      active.push_back(node_id);
+    }
+  }
+
+  std::vector<NodeId> candidates(graph.num_nodes(), invalid_node_id);
+  parallel_for_blocks(
+      active.size(), num_threads,
+      [&](std::size_t const begin, std::size_t const end) {
+        for (std::size_t idx = begin; idx < end; ++idx) {
+          candidates[active[idx]] =
+              heaviest_exposed_neighbor(graph, states, seed, active[idx]);
+        }
+      });
+
+  while (not active.empty()) {
+    parallel_for_blocks(
+        active.size(), num_threads,
+        [&](std::size_t const begin, std::size_t const end) {
+          for (std::size_t idx = begin; idx < end; ++idx) {
+            NodeId const node_id = active[idx];
+            NodeId const candidate_id = candidates[node_id];
+            if (candidate_id != invalid_node_id and
+                candidates[candidate_id] == node_id and node_id < candidate_id) {
+              states[node_id] = MATCHED_NOW;
+              states[candidate_id] = MATCHED_NOW;
+            }
+          }
+        });
+
+    parallel_for_blocks(
+        active.size(), num_threads,
+        [&](std::size_t const begin, std::size_t const end) {
+          for (std::size_t idx = begin; idx < end; ++idx) {
+            NodeId const node_id = active[idx];
+            if (states[node_id] == EXPOSED and
+                states[candidates[node_id]] != EXPOSED) {
+              candidates[node_id] =
+                  heaviest_exposed_neighbor(graph, states, seed, node_id);
+            }
+          }
+        });
+
+    active.erase(std::remove_if(active.begin(), active.end(),
+                                [&](NodeId const node_id) {
+                                  return states[node_id] != EXPOSED or
+                                         candidates[node_id] == invalid_node_id;
+                                }),
+                 active.end());
+  }
+
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (states[node_id] == MATCHED_NOW and node_id < candidates[node_id]) {
+      matching.match(node_id, candidates[node_id]);
+    }
+  }
+}
+
+} // namespace
+
+void initialize_matching(CsrGraph const &graph, Matching &matching,
+                         MatchingInitializer const initializer,
+                         std::uint64_t const seed, unsigned const num_threads) {
+  switch (initializer) {
+  case MatchingInitializer::greedy:
+    greedy(graph, matching);
+    break;
+  case MatchingInitializer::min_degree:
+    min_degree(graph, matching);
+    break;
+  case MatchingInitializer::karp_sipser:
+    karp_sipser(graph, matching, seed);
+    break;
+  case MatchingInitializer::locally_dominant:
+    locally_dominant(graph, matching, seed, num_threads);
+    break;
+  }
+}
+
+} // namespace ED
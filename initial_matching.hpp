@@ -0,0 +1,52 @@
+#ifndef INITIAL_MATCHING_HPP
+#define INITIAL_MATCHING_HPP
+
+/**
+   @file initial_matching.hpp
+
+   @brief Heuristics that compute a maximal matching to start the exact
+algorithms from. The fewer nodes they leave exposed, the fewer augmenting path
+searches are needed afterwards.
+**/
+
+#include <cstdint>
+
+#include "csr_graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+//! Heuristics for the initial matching.
+enum class MatchingInitializer {
+  //! Matches every exposed node to its first exposed neighbor
+  greedy,
+  //! Repeatedly matches an exposed node of minimum degree to its neighbor of
+  //! minimum degree (degrees count exposed neighbors only)
+  min_degree,
+  //! Matches nodes of degree one to their only exposed neighbor while there
+  //! are any, otherwise matches a random edge (Karp-Sipser)
+  karp_sipser,
+  //! Parallel: every edge gets a pseudo-random priority from the seed, and
+  //! edges whose priority is maximal at both endpoints are matched in rounds
+  //! (locally dominant matching)
+  locally_dominant
+};
+
+/**
+   @brief Extends @c matching by the given heuristic to a maximal matching.
+
+   @param seed Seed for the random choices of @c karp_sipser and the edge
+priorities of @c locally_dominant.
+   @param num_threads Number of threads used by @c locally_dominant.
+
+   The result only depends on the graph, the input matching and the seed, not
+on the number of threads.
+**/
+void initialize_matching(CsrGraph const &graph, Matching &matching,
+                         MatchingInitializer const initializer,
+                         std::uint64_t const seed = 0,
+                         unsigned const num_threads = 1);
+
+} // namespace ED
+
+#endif /* INITIAL_MATCHING_HPP */
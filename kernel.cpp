@@ -0,0 +1,205 @@
+#include "kernel.hpp" // always include corresponding header first
+
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <utility>
+
+namespace ED {
+
+namespace {
+
+NodeId find_representative(std::vector<NodeId> const &parent,
+                           NodeId node_id) {
+  while (parent[node_id] != node_id) {
+    node_id = parent[node_id];
+  }
+  return node_id;
+}
+
+} // namespace
+
+Kernel::Kernel(CsrGraph const &graph) : _graph(reduce(graph)) {}
+
+CsrGraph Kernel::reduce(CsrGraph const &graph) {
+  _num_nodes = graph.num_nodes();
+  _parent.resize(_num_nodes);
+  std::iota(_parent.begin(), _parent.end(), NodeId(0));
+  auto const find = [&](NodeId const node_id) {
+    return find_representative(_parent, node_id);
+  };
+
+  // The nodes of every set form a circular list, so merging two sets takes
+  // constant time. The edges of a set are those of its nodes; edges to
+  // removed sets and edges inside the set (from folds) are skipped, the
+  // degree counts only the others.
+  std::vector<NodeId> next_nodes(_num_nodes);
+  std::iota(next_nodes.begin(), next_nodes.end(), NodeId(0));
+  std::vector<std::size_t> num_edges(_num_nodes);
+  auto const for_each_edge = [&](NodeId const set_id, auto const &f) {
+    NodeId node_id = set_id;
+    do {
+      for (NodeId const neighbor_id : graph.node(node_id).neighbors()) {
+        f(Edge(node_id, neighbor_id));
+      }
+      node_id = next_nodes[node_id];
+    } while (node_id != set_id);
+  };
+  std::vector<std::size_t> degree(_num_nodes);
+  std::vector<bool> removed(_num_nodes, false);
+  // Candidates for a reduction, sets of degree 0 or 1 go first
+  std::vector<NodeId> low_degree;
+  std::vector<NodeId> degree_two;
+  auto const push_candidate = [&](NodeId const set_id) {
+    if (degree[set_id] < 2) {
+      low_degree.push_back(set_id);
+    } else if (degree[set_id] == 2) {
+      degree_two.push_back(set_id);
+    }
+  };
+  for (NodeId node_id = 0; node_id < _num_nodes; ++node_id) {
+    degree[node_id] = graph.node(node_id).degree();
+    num_edges[node_id] = degree[node_id];
+    push_candidate(node_id);
+  }
+
+  auto const remove = [&](NodeId const set_id) {
+    removed[set_id] = true;
+    for_each_edge(set_id, [&](Edge const &edge) {
+      NodeId const other_id = find(edge.second);
+      if (other_id != set_id and not removed[other_id]) {
+        --degree[other_id];
+        push_candidate(other_id);
+      }
+    });
+  };
+
+  Edge live_edges[2];
+  while (not low_degree.empty() or not degree_two.empty()) {
+    std::vector<NodeId> &candidates =
+        low_degree.empty() ? degree_two : low_degree;
+    NodeId const set_id = candidates.back();
+    candidates.pop_back();
+    if (removed[set_id] or _parent[set_id] != set_id or degree[set_id] > 2) {
+      continue;
+    }
+    std::size_t num_live = 0;
+    for_each_edge(set_id, [&](Edge const &edge) {
+      NodeId const other_id = find(edge.second);
+      if (other_id != set_id and not removed[other_id]) {
+        live_edges[num_live++] = edge;
+      }
+    });
+    assert(num_live == degree[set_id]);
+    removed[set_id] = true;
+    if (num_live == 0) {
+      continue;
+    }
+
+    // A single neighbor (possibly over two parallel edges) is matched
+    NodeId const first_id = find(live_edges[0].second);
+    NodeId const second_id =
+        num_live == 1 ? first_id : find(live_edges[1].second);
+    if (first_id == second_id) {
+      _reductions.push_back({invalid_node_id, live_edges[0], Edge()});
+      remove(first_id);
+      continue;
+    }
+
+    // Fold: edges between the two sets become edges inside the merged set,
+    // they are counted from the set with fewer edges
+    --degree[first_id];
+    --degree[second_id];
+    NodeId const smaller_id =
+        num_edges[first_id] < num_edges[second_id] ? first_id : second_id;
+    NodeId const larger_id = smaller_id == first_id ? second_id : first_id;
+    std::size_t num_inner_edges = 0;
+    for_each_edge(smaller_id, [&](Edge const &edge) {
+      if (find(edge.second) == larger_id) {
+        ++num_inner_edges;
+      }
+    });
+
+    // Union by number of edges keeps the trees of depth O(log m)
+    NodeId const representative_id = larger_id;
+    NodeId const child_id = smaller_id;
+    _parent[child_id] = representative_id;
+    std::swap(next_nodes[representative_id], next_nodes[child_id]);
+    num_edges[representative_id] += num_edges[child_id];
+    degree[representative_id] =
+        degree[first_id] + degree[second_id] - 2 * num_inner_edges;
+    push_candidate(representative_id);
+    _reductions.push_back({child_id, live_edges[0], live_edges[1]});
+  }
+
+  // The remaining sets are the kernel nodes, every edge between two of them
+  // is in both of their lists
+  std::vector<NodeId> kernel_ids(_num_nodes, invalid_node_id);
+  for (NodeId node_id = 0; node_id < _num_nodes; ++node_id) {
+    if (_parent[node_id] == node_id and not removed[node_id]) {
+      kernel_ids[node_id] = _representatives.size();
+      _representatives.push_back(node_id);
+    }
+  }
+  for (NodeId const set_id : _representatives) {
+    for_each_edge(set_id, [&](Edge const &edge) {
+      NodeId const other_id = find(edge.second);
+      if (not removed[other_id] and kernel_ids[set_id] < kernel_ids[other_id]) {
+        _edges.emplace_back(kernel_ids[set_id], kernel_ids[other_id]);
+        _original_edges.push_back(edge);
+      }
+    });
+  }
+  return CsrGraph(_representatives.size(), _edges);
+}
+
+Matching Kernel::lift(Matching const &kernel_matching) const {
+  assert(kernel_matching.num_nodes() == _graph.num_nodes());
+  std::vector<NodeId> parent = _parent;
+  // The node of every set that is matched to a node outside of it; the other
+  // nodes of the set are matched when the set is unfolded
+  std::vector<NodeId> matched_nodes(_num_nodes, invalid_node_id);
+  Matching matching(_num_nodes);
+  auto const match = [&](Edge const &edge) {
+    matching.match(edge.first, edge.second);
+    matched_nodes[find_representative(parent, edge.first)] = edge.first;
+    matched_nodes[find_representative(parent, edge.second)] = edge.second;
+  };
+
+  for (std::size_t edge_idx = 0; edge_idx < _edges.size(); ++edge_idx) {
+    Edge const &edge = _edges[edge_idx];
+    if (kernel_matching.mate(edge.first) == edge.second and
+        matched_nodes[_representatives[edge.first]] == invalid_node_id) {
+      match(_original_edges[edge_idx]);
+    }
+  }
+
+  for (auto it = _reductions.rbegin(); it != _reductions.rend(); ++it) {
+    if (it->fold == invalid_node_id) {
+      match(it->first);
+      continue;
+    }
+    // Split the merged set again; the removed node is matched to the part
+    // that does not contain the matched node (to any part if there is none)
+    NodeId const merged_id = parent[it->fold];
+    NodeId const matched_id = matched_nodes[merged_id];
+    parent[it->fold] = it->fold;
+    matched_nodes[merged_id] = invalid_node_id;
+    if (matched_id == invalid_node_id) {
+      match(it->first);
+      continue;
+    }
+    matched_nodes[find_representative(parent, matched_id)] = matched_id;
+    if (find_representative(parent, matched_id) ==
+        find_representative(parent, it->first.second)) {
+      match(it->second);
+    } else {
+      match(it->first);
+    }
+  }
+  assert(matching.num_edges() ==
+         kernel_matching.num_edges() + _reductions.size());
+  return matching;
+}
+
+} // namespace ED
@@ -0,0 +1,85 @@
+#ifndef KERNEL_HPP
+#define KERNEL_HPP
+
+/**
+   @file kernel.hpp
+
+   @brief Exact data reductions that shrink a graph to a smaller kernel before
+the maximum matching is computed, and the lifting of a maximum matching of the
+kernel back to the original graph.
+**/
+
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+/**
+   @class Kernel
+
+   @brief The graph left over after repeatedly applying these reductions, each
+of which keeps a maximum matching computable:
+
+   - A node without neighbors is removed.
+   - A node with a single neighbor is matched to it and both are removed.
+   - A node @c v with exactly two neighbors @c u and @c w is removed, and @c u
+     and @c w are merged into one node adjacent to the neighbors of both (the
+     fold). A maximum matching of the folded graph has exactly one edge less
+     than one of the graph before the fold.
+
+   Merged nodes stand for sets of original nodes; of every original edge
+between two sets, the kernel keeps its endpoints, so a kernel matching can be
+turned back into original edges. Parallel edges may arise and are kept.
+
+   The reductions take O(m log^2 m) time: merging two sets only links their
+node lists, the edges between them are counted from the set with fewer edges,
+and the sets form a union-find structure with union by number of edges
+(without path compression, so that @c lift can undo the folds).
+**/
+class Kernel {
+public:
+  /** @brief Reduces @c graph as far as the reductions apply. **/
+  explicit Kernel(CsrGraph const &graph);
+
+  /** @return The reduced graph, on its own compact node ids. **/
+  CsrGraph const &graph() const { return _graph; }
+
+  /**
+     @brief Turns a matching of @c graph() into a matching of the original
+  graph with <tt>num_reductions()</tt> more edges, undoing the folds in reverse
+  order. If @c kernel_matching is maximum, so is the result.
+  **/
+  Matching lift(Matching const &kernel_matching) const;
+
+  /** @return The number of edges the reductions add to every matching. **/
+  NodeId num_reductions() const { return _reductions.size(); }
+
+private:
+  // Either a matched pair (first, with fold == invalid_node_id), or a fold:
+  // the edges from the removed node to its two neighbors, and the
+  // representative that was merged into the other one
+  struct Reduction {
+    NodeId fold;
+    Edge first;
+    Edge second;
+  };
+
+  CsrGraph reduce(CsrGraph const &graph);
+
+  NodeId _num_nodes = 0;
+  // Union-find forest of the merged sets
+  std::vector<NodeId> _parent;
+  std::vector<Reduction> _reductions;
+  // Representative of every kernel node, and the kernel edges with the
+  // original edges they stand for
+  std::vector<NodeId> _representatives;
+  std::vector<Edge> _edges;
+  std::vector<Edge> _original_edges;
+  CsrGraph _graph;
+}; // class Kernel
+
+} // namespace ED
+
+#endif /* KERNEL_HPP */
@@ -1,22 +1,281 @@
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <fstream>  // For reading input files.
 #include <iostream> // For writing to the standard output.
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "batch.hpp"
+#include "binary_graph.hpp"
+#include "certificate.hpp"
+#include "csr_graph.hpp"
+#include "dimacs.hpp"
 #include "graph.hpp"
+#include "matching_writer.hpp"
 #include "maximum_cardinality_matching.hpp"
+#include "parallel.hpp"
+#include "phase_matching.hpp"
+#include "stats.hpp"
+#include "weighted_matching.hpp"
+
+namespace {
+
+void print_usage(char const *program) {
+  std::cout << "Usage: " << program
+            << " [--threads <n>] [--verify] [--convert <binary file>]"
+               " [--output <file>] [--format dimacs|binary]"
+               " [--engine edmonds|phases|incremental|parallel|hopcroft-karp]"
+               " [--no-bipartite-check] [--no-components] [--no-kernel]"
+               " [--init greedy|min-degree|karp-sipser|locally-dominant]"
+               " [--seed <n>] [--report] [--stats] [--certify] [--weighted]"
+               " <graph file>\n"
+            << "       " << program
+            << " --batch <list file or directory> [--output <directory>]"
+               " [--verify] [--certify] [matching options]"
+            << std::endl;
+}
+
+bool parse_initializer(char const *name, MatchingInitializer &initializer) {
+  if (std::strcmp(name, "greedy") == 0) {
+    initializer = MatchingInitializer::greedy;
+  } else if (std::strcmp(name, "min-degree") == 0) {
+    initializer = MatchingInitializer::min_degree;
+  } else if (std::strcmp(name, "karp-sipser") == 0) {
+    initializer = MatchingInitializer::karp_sipser;
+  } else if (std::strcmp(name, "locally-dominant") == 0) {
+    initializer = MatchingInitializer::locally_dominant;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Prints the timings and counters of a run as one JSON object
+void print_stats(std::ostream &str, MatchingReport const &report,
+                 double const parse_seconds, double const solve_seconds,
+                 double const output_seconds,
+                 std::size_t const matching_size) {
+  str << "{\"stats_enabled\": " << (ED_STATS ? "true" : "false")
+      << ", \"engine\": \"" << engine_name(report.engine)
+      << "\", \"parse_seconds\": " << parse_seconds
+      << ", \"reduction_seconds\": " << report.reduction_seconds
+      << ", \"initial_matching_seconds\": " << report.initial_matching_seconds
+      << ", \"tree_growth_seconds\": " << report.tree_growth_seconds
+      << ", \"blossom_shrink_seconds\": " << report.blossom_shrink_seconds
+      << ", \"augment_seconds\": " << report.augment_seconds
+      << ", \"solve_seconds\": " << solve_seconds
+      << ", \"output_seconds\": " << output_seconds
+      << ", \"matching_size\": " << matching_size
+      << ", \"initial_matching_size\": " << report.initial_matching_size
+      << ", \"augmentations\": " << report.num_augmentations
+      << ", \"frustrated_trees\": " << report.frustrated_trees
+      << ", \"blossoms_shrunk\": " << report.blossoms_shrunk
+      << ", \"max_blossom_depth\": " << report.max_blossom_depth
+      << ", \"edges_scanned\": " << report.edges_scanned
+      << ", \"kernel_nodes\": " << report.kernel_num_nodes
+      << ", \"kernel_edges\": " << report.kernel_num_edges
+      << ", \"components\": " << report.num_components
+      << ", \"peak_rss_bytes\": " << ED::peak_rss_bytes() << "}"
+      << std::endl;
+}
+
+} // namespace
 
 int main(int argc, char **argv) {
-  if (argc != 2) {
-    std::cout << "Expected one argument, found " << argc - 1 << std::endl;
+  unsigned num_threads = ED::default_num_threads();
+  std::string filename;
+  std::string batch;
+  std::string binary_output;
+  std::string output;
+  ED::MatchingFormat format = ED::MatchingFormat::dimacs;
+  bool verify = false;
+  MatchingOptions options;
+  bool report = false;
+  bool stats = false;
+  bool certify = false;
+  bool weighted = false;
+
+  for (int arg_idx = 1; arg_idx < argc; ++arg_idx) {
+    if (std::strcmp(argv[arg_idx], "--threads") == 0 and arg_idx + 1 < argc) {
+      num_threads = std::max(std::stoi(argv[++arg_idx]), 1);
+    } else if (std::strcmp(argv[arg_idx], "--convert") == 0 and
+               arg_idx + 1 < argc) {
+      binary_output = argv[++arg_idx];
+    } else if (std::strcmp(argv[arg_idx], "--batch") == 0 and
+               arg_idx + 1 < argc) {
+      batch = argv[++arg_idx];
+    } else if (std::strcmp(argv[arg_idx], "--verify") == 0) {
+      verify = true;
+    } else if (std::strcmp(argv[arg_idx], "--output") == 0 and
+               arg_idx + 1 < argc) {
+      output = argv[++arg_idx];
+    } else if (std::strcmp(argv[arg_idx], "--format") == 0 and
+               arg_idx + 1 < argc and
+               (std::strcmp(argv[arg_idx + 1], "dimacs") == 0 or
+                std::strcmp(argv[arg_idx + 1], "binary") == 0)) {
+      format = std::strcmp(argv[++arg_idx], "binary") == 0
+                   ? ED::MatchingFormat::binary
+                   : ED::MatchingFormat::dimacs;
+    } else if (std::strcmp(argv[arg_idx], "--engine") == 0 and
+               arg_idx + 1 < argc and
+               parse_engine(argv[arg_idx + 1], options.engine)) {
+      ++arg_idx;
+    } else if (std::strcmp(argv[arg_idx], "--init") == 0 and
+               arg_idx + 1 < argc and
+               parse_initializer(argv[arg_idx + 1], options.initializer)) {
+      ++arg_idx;
+    } else if (std::strcmp(argv[arg_idx], "--seed") == 0 and
+               arg_idx + 1 < argc) {
+      options.seed = std::stoull(argv[++arg_idx]);
+    } else if (std::strcmp(argv[arg_idx], "--report") == 0) {
+      report = true;
+    } else if (std::strcmp(argv[arg_idx], "--stats") == 0) {
+      stats = true;
+    } else if (std::strcmp(argv[arg_idx], "--certify") == 0) {
+      certify = true;
+    } else if (std::strcmp(argv[arg_idx], "--no-bipartite-check") == 0) {
+      options.detect_bipartite = false;
+    } else if (std::strcmp(argv[arg_idx], "--no-components") == 0) {
+      options.split_components = false;
+    } else if (std::strcmp(argv[arg_idx], "--no-kernel") == 0) {
+      options.reduce_graph = false;
+    } else if (std::strcmp(argv[arg_idx], "--weighted") == 0) {
+      weighted = true;
+    } else if (filename.empty() and argv[arg_idx][0] != '-') {
+      filename = argv[arg_idx];
+    } else {
+      print_usage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (filename.empty() == batch.empty()) {
+    print_usage(argv[0]);
     return EXIT_FAILURE;
   }
+  // Reports and conversion are per graph, weights are not supported in batches
+  if (not batch.empty() and
+      (weighted or report or stats or not binary_output.empty())) {
+    std::cerr << "--batch cannot be combined with --weighted, --report, "
+                 "--stats or --convert."
+              << std::endl;
+    print_usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (not batch.empty()) {
+    // Every graph is solved on one thread, the threads take different graphs
+    std::vector<ED::BatchJob> const jobs = ED::list_batch_jobs(batch, output);
+    ED::BatchResult const result =
+        ED::solve_batch(jobs, options, format, verify, certify, num_threads);
+    for (std::size_t job_idx = 0; job_idx < jobs.size(); ++job_idx) {
+      if (not result.errors[job_idx].empty()) {
+        std::cerr << "c " << jobs[job_idx].input << ": "
+                  << result.errors[job_idx] << std::endl;
+      }
+    }
+    std::cerr << "c batch: " << result.num_solved << " of " << jobs.size()
+              << " graphs solved in " << result.seconds << " s ("
+              << (result.seconds > 0 ? result.num_solved / result.seconds : 0)
+              << " graphs/s), " << result.num_matching_edges
+              << " matching edges" << std::endl;
+    return result.num_solved == jobs.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
 
-  ED::Graph const graph = ED::Graph::build_graph(std::string(argv[1]));
+  if (weighted) {
+    // Binary graph files carry no weights
+    ED::MappedFile const file(filename);
+    if (ED::is_binary_graph(file)) {
+      std::cerr << "--weighted needs a DIMACS file." << std::endl;
+      return EXIT_FAILURE;
+    }
+    ED::DimacsInstance const instance =
+        ED::read_dimacs(file, num_threads, true);
+    ED::Weight total_weight = 0;
+    ED::Matching const max_weight_matching =
+        ED::compute_maximum_weight_matching(
+            instance.num_nodes, instance.edges, instance.weights,
+            &total_weight);
+    if (report) {
+      std::cerr << "c maximum weight matching: "
+                << max_weight_matching.num_edges() << " edges, weight "
+                << total_weight << std::endl;
+    }
+    if (output.empty()) {
+      ED::BufferedWriter writer;
+      ED::write_matching(writer, max_weight_matching, format);
+    } else {
+      ED::BufferedWriter writer(output);
+      ED::write_matching(writer, max_weight_matching, format);
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // Binary graph files are mapped directly, anything else is read as DIMACS
+  ED::Stopwatch const parse_stopwatch;
+  ED::CsrGraph const graph = ED::load_graph(filename, num_threads, verify);
 
-  ED::Graph max_cardinality_matching =
-      compute_maximum_cardinality_matching(graph);
-  std::cout << max_cardinality_matching << std::endl;
+  if (not binary_output.empty()) {
+    ED::write_binary_graph(graph, binary_output);
+    return EXIT_SUCCESS;
+  }
+
+  double const parse_seconds = parse_stopwatch.seconds();
+  options.num_threads = num_threads;
+  MatchingReport matching_report;
+  ED::Stopwatch const solve_stopwatch;
+  ED::Matching const max_cardinality_matching =
+      compute_maximum_cardinality_matching(graph, options, &matching_report);
+  double const solve_seconds = solve_stopwatch.seconds();
+  if (report) {
+    // Comment lines, so the report can be kept with DIMACS output
+    std::cerr << "c engine: " << engine_name(matching_report.engine) << "\n"
+              << "c kernel: " << matching_report.kernel_num_nodes
+              << " nodes, " << matching_report.kernel_num_edges << " edges\n"
+              << "c components: " << matching_report.num_components << "\n"
+              << "c initial matching: "
+              << matching_report.initial_matching_size << " edges\n"
+              << "c nodes scanned for roots: "
+              << matching_report.root_nodes_scanned << "\n"
+              << "c augmentations: " << matching_report.num_augmentations
+              << ", rescanned nodes: " << matching_report.rescanned_nodes
+              << " ("
+              << (matching_report.num_augmentations == 0
+                      ? 0.0
+                      : double(matching_report.rescanned_nodes) /
+                            matching_report.num_augmentations)
+              << " per augmentation)\n"
+              << "c maximum matching: " << max_cardinality_matching.num_edges()
+              << " edges" << std::endl;
+  }
+  if (certify) {
+    // The witness is checked independently of the engine
+    ED::Stopwatch const certify_stopwatch;
+    std::vector<ED::NodeId> const barrier =
+        ED::find_tutte_berge_barrier(graph, max_cardinality_matching);
+    bool const certified = ED::verify_maximum_matching(
+        graph, max_cardinality_matching, barrier, num_threads);
+    std::cerr << "c certificate: barrier of " << barrier.size() << " nodes, "
+              << (certified ? "verified" : "rejected") << " in "
+              << certify_stopwatch.seconds() << " s" << std::endl;
+    if (not certified) {
+      return EXIT_FAILURE;
+    }
+  }
+  ED::Stopwatch const output_stopwatch;
+  if (output.empty()) {
+    ED::BufferedWriter writer;
+    ED::write_matching(writer, max_cardinality_matching, format);
+  } else {
+    ED::BufferedWriter writer(output);
+    ED::write_matching(writer, max_cardinality_matching, format);
+  }
+  if (stats) {
+    print_stats(std::cerr, matching_report, parse_seconds, solve_seconds,
+                output_stopwatch.seconds(),
+                max_cardinality_matching.num_edges());
+  }
 
   return EXIT_SUCCESS;
 }
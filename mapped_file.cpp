@@ -0,0 +1,105 @@
+#include "mapped_file.hpp" // always include corresponding header first
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+#include <utility>
+
+namespace ED {
+
+namespace {
+std::size_t constexpr read_block_size = std::size_t(1) << 22;
+} // namespace
+
+MappedFile::MappedFile(const std::string &filename, Access const access) {
+  int const fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open input file.");
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) == 0 and S_ISREG(file_stat.st_mode) and
+      file_stat.st_size > 0) {
+    void *const address = ::mmap(nullptr, file_stat.st_size, PROT_READ,
+                                 MAP_PRIVATE, fd, 0);
+    if (address != MAP_FAILED) {
+      if (access == Access::sequential) {
+        ::madvise(address, file_stat.st_size, MADV_SEQUENTIAL);
+      }
+      _data = static_cast<char const *>(address);
+      _size = file_stat.st_size;
+      _mapped = true;
+      ::close(fd);
+      return;
+    }
+  }
+
+  // Fall back to reading the file in large blocks
+  while (true) {
+    std::size_t const old_size = _buffer.size();
+    _buffer.resize(old_size + read_block_size);
+    ssize_t const num_read = ::read(fd, _buffer.data() + old_size, read_block_size);
+    if (num_read < 0) {
+      ::close(fd);
+      throw std::runtime_error("Could not read input file.");
+    }
+    _buffer.resize(old_size + num_read);
+    if (num_read == 0) {
+      break;
+    }
+  }
+  ::close(fd);
+  _data = _buffer.data();
+  _size = _buffer.size();
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+void MappedFile::advise(Access const access) const {
+  if (_mapped) {
+    ::madvise(const_cast<char *>(_data), _size,
+              access == Access::sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+  }
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : _data(other._data), _size(other._size), _mapped(other._mapped),
+      _buffer(std::move(other._buffer)) {
+  if (not _mapped) {
+    _data = _buffer.data();
+  }
+  other._data = nullptr;
+  other._size = 0;
+  other._mapped = false;
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+  if (this != &other) {
+    unmap();
+    _data = other._data;
+    _size = other._size;
+    _mapped = other._mapped;
+    _buffer = std::move(other._buffer);
+    if (not _mapped) {
+      _data = _buffer.data();
+    }
+    other._data = nullptr;
+    other._size = 0;
+    other._mapped = false;
+  }
+  return *this;
+}
+
+void MappedFile::unmap() {
+  if (_mapped) {
+    ::munmap(const_cast<char *>(_data), _size);
+    _mapped = false;
+  }
+  _data = nullptr;
+  _size = 0;
+}
+
+} // namespace ED
@@ -0,0 +1,58 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+/**
+   @file mapped_file.hpp
+
+   @brief Read-only access to the full contents of a file via mmap.
+**/
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ED {
+
+/**
+   @class MappedFile
+
+   @brief Maps a file read-only into memory. If the file cannot be mapped (e.g.
+it is a pipe), its contents are read into a buffer in large blocks instead, so
+@c data() is available in either case.
+**/
+class MappedFile {
+public:
+  //! Hint for the kernel how the mapping will be read.
+  enum class Access { normal, sequential };
+
+  /** @brief Opens and maps @c filename, throws if it cannot be read. **/
+  explicit MappedFile(const std::string &filename,
+                      Access const access = Access::sequential);
+  ~MappedFile();
+
+  MappedFile(MappedFile const &) = delete;
+  MappedFile &operator=(MappedFile const &) = delete;
+  MappedFile(MappedFile &&other) noexcept;
+  MappedFile &operator=(MappedFile &&other) noexcept;
+
+  /** @return Pointer to the first byte of the file. **/
+  char const *data() const { return _data; }
+
+  /** @return The size of the file in bytes. **/
+  std::size_t size() const { return _size; }
+
+  /** @brief Changes the access hint for the mapping (no-op for a buffer). **/
+  void advise(Access const access) const;
+
+private:
+  void unmap();
+
+  char const *_data = nullptr;
+  std::size_t _size = 0;
+  bool _mapped = false;
+  std::vector<char> _buffer;
+};
+
+} // namespace ED
+
+#endif /* MAPPED_FILE_HPP */
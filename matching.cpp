@@ -0,0 +1,50 @@
+#include "matching.hpp" // always include corresponding header first
+
+#include <cassert>
+#include <iostream>
+
+namespace ED {
+
+Matching::Matching(NodeId const num_nodes)
+    : _mates(num_nodes, invalid_node_id) {}
+
+void Matching::augment(std::vector<NodeId> const &path) {
+  assert(path.size() % 2 == 0);
+  assert(path.empty() or (is_exposed(path.front()) and is_exposed(path.back())));
+  for (std::size_t idx = 0; idx + 1 < path.size(); idx += 2) {
+    _mates[path[idx]] = path[idx + 1];
+    _mates[path[idx + 1]] = path[idx];
+  }
+  if (not path.empty()) {
+    ++_num_edges;
+  }
+}
+
+Graph Matching::to_graph() const {
+  Graph graph(num_nodes());
+  for (NodeId node_id = 0; node_id < num_nodes(); ++node_id) {
+    if (not is_exposed(node_id) and node_id < mate(node_id)) {
+      graph.add_edge(node_id, mate(node_id));
+    }
+  }
+  return graph;
+}
+
+std::ostream &operator<<(std::ostream &str, Matching const &matching) {
+  str << "c This encodes a graph in DIMACS format\n"
+      << "p edge " << matching.num_nodes() << " " << matching.num_edges()
+      << "\n";
+
+  for (NodeId node_id = 0; node_id < matching.num_nodes(); ++node_id) {
+    // output each edge only once
+    if (not matching.is_exposed(node_id) and node_id < matching.mate(node_id)) {
+      str << "e " << to_dimacs_id(node_id) << " "
+          << to_dimacs_id(matching.mate(node_id)) << "\n";
+    }
+  }
+
+  str << std::flush;
+  return str;
+}
+
+} // namespace ED
@@ -0,0 +1,102 @@
+#ifndef MATCHING_HPP
+#define MATCHING_HPP
+
+/**
+   @file matching.hpp
+
+   @brief This file provides the class @c Matching which stores a matching as
+an array of mates.
+**/
+
+#include <iosfwd>
+#include <vector>
+
+#include "graph.hpp"
+
+namespace ED {
+
+/**
+   @class Matching
+
+   @brief A matching on the nodes 0, ..., num_nodes - 1, stored as one array
+entry per node (its mate, or @c invalid_node_id if the node is exposed).
+
+   Changing the matching along an augmenting path only touches the nodes on the
+path, so an augmentation costs O(path length) instead of rebuilding a graph.
+**/
+class Matching {
+public:
+  typedef std::size_t size_type;
+
+  /** @brief Creates the empty matching on @c num_nodes nodes. **/
+  explicit Matching(NodeId const num_nodes);
+
+  /** @return The number of nodes. **/
+  NodeId num_nodes() const { return _mates.size(); }
+
+  /** @return The number of matching edges. **/
+  size_type num_edges() const { return _num_edges; }
+
+  /** @return The mate of @c id, or @c invalid_node_id if @c id is exposed. **/
+  NodeId mate(NodeId const id) const { return _mates[id]; }
+
+  /** @return Whether @c id is not covered by the matching. **/
+  bool is_exposed(NodeId const id) const {
+    return _mates[id] == invalid_node_id;
+  }
+
+  /**
+     @brief Adds the edge <tt>{a, b}</tt>. If @c a or @c b is currently
+  matched, its matching edge is removed first.
+  **/
+  void match(NodeId const a, NodeId const b);
+
+  /** @brief Removes the matching edge covering @c id, if any. **/
+  void unmatch(NodeId const id);
+
+  /**
+     @brief Augments along the alternating path <tt>path[0], path[1], ...</tt>
+  by matching <tt>path[0]</tt> with <tt>path[1]</tt>, <tt>path[2]</tt> with
+  <tt>path[3]</tt> and so on.
+
+     @warning @c path must have even length, start and end in exposed nodes and
+  alternate between non-matching and matching edges.
+  **/
+  void augment(std::vector<NodeId> const &path);
+
+  /** @return The matching as a @c Graph (each node has degree at most 1). **/
+  Graph to_graph() const;
+
+  /**
+    @brief Prints the matching to the given ostream in DIMACS format.
+  **/
+  friend std::ostream &operator<<(std::ostream &str, Matching const &matching);
+
+private:
+  std::vector<NodeId> _mates;
+  size_type _num_edges = 0;
+}; // class Matching
+
+// BEGIN: Inline section
+
+inline void Matching::unmatch(NodeId const id) {
+  NodeId const mate = _mates[id];
+  if (mate != invalid_node_id) {
+    _mates[mate] = invalid_node_id;
+    _mates[id] = invalid_node_id;
+    --_num_edges;
+  }
+}
+
+inline void Matching::match(NodeId const a, NodeId const b) {
+  unmatch(a);
+  unmatch(b);
+  _mates[a] = b;
+  _mates[b] = a;
+  ++_num_edges;
+}
+// END: Inline section
+
+} // namespace ED
+
+#endif /* MATCHING_HPP */
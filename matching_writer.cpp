@@ -0,0 +1,112 @@
+#include "matching_writer.hpp" // always include corresponding header first
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+namespace ED {
+
+namespace {
+char constexpr binary_magic[8] = {'E', 'D', 'M', 'A', 'T', 'C', 'H', '1'};
+} // namespace
+
+BufferedWriter::BufferedWriter()
+    : _fd(STDOUT_FILENO), _owns_fd(false), _buffer(buffer_size) {}
+
+BufferedWriter::BufferedWriter(const std::string &filename)
+    : _fd(::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)),
+      _owns_fd(true), _buffer(buffer_size) {
+  if (_fd < 0) {
+    throw std::runtime_error("Could not open output file.");
+  }
+}
+
+BufferedWriter::~BufferedWriter() {
+  try {
+    flush();
+  } catch (...) {
+    // Destructors must not throw, call flush() explicitly to see errors
+  }
+  if (_owns_fd) {
+    ::close(_fd);
+  }
+}
+
+void BufferedWriter::write(char const *data, std::size_t const size) {
+  if (size > _buffer.size()) {
+    flush();
+    _buffer.resize(size);
+  }
+  reserve(size);
+  std::memcpy(_buffer.data() + _used, data, size);
+  _used += size;
+}
+
+void BufferedWriter::write_decimal(std::uint64_t const value) {
+  reserve(20);
+  char *const begin = _buffer.data() + _used;
+  _used = std::to_chars(begin, begin + 20, value).ptr - _buffer.data();
+}
+
+void BufferedWriter::write_binary(std::uint64_t const value) {
+  reserve(sizeof(value));
+  std::memcpy(_buffer.data() + _used, &value, sizeof(value));
+  _used += sizeof(value);
+}
+
+void BufferedWriter::flush() {
+  std::size_t written = 0;
+  while (written < _used) {
+    ssize_t const result =
+        ::write(_fd, _buffer.data() + written, _used - written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      _used = 0;
+      throw std::runtime_error("Could not write output.");
+    }
+    written += result;
+  }
+  _used = 0;
+}
+
+void write_matching(BufferedWriter &writer, Matching const &matching,
+                    MatchingFormat const format) {
+  if (format == MatchingFormat::binary) {
+    writer.write(binary_magic, sizeof(binary_magic));
+    writer.write_binary(matching.num_nodes());
+    writer.write_binary(matching.num_edges());
+  } else {
+    writer.write("c This encodes a graph in DIMACS format\np edge ");
+    writer.write_decimal(matching.num_nodes());
+    writer.write(" ", 1);
+    writer.write_decimal(matching.num_edges());
+    writer.write("\n", 1);
+  }
+
+  for (NodeId node_id = 0; node_id < matching.num_nodes(); ++node_id) {
+    NodeId const mate_id = matching.mate(node_id);
+    // output each edge only once (exposed nodes have mate invalid_node_id)
+    if (mate_id == invalid_node_id or node_id >= mate_id) {
+      continue;
+    }
+    if (format == MatchingFormat::binary) {
+      writer.write_binary(node_id);
+      writer.write_binary(mate_id);
+    } else {
+      writer.write("e ", 2);
+      writer.write_decimal(to_dimacs_id(node_id));
+      writer.write(" ", 1);
+      writer.write_decimal(to_dimacs_id(mate_id));
+      writer.write("\n", 1);
+    }
+  }
+  writer.flush();
+}
+
+} // namespace ED
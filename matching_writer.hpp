@@ -0,0 +1,84 @@
+#ifndef MATCHING_WRITER_HPP
+#define MATCHING_WRITER_HPP
+
+/**
+   @file matching_writer.hpp
+
+   @brief Fast output of matchings: integers are formatted with @c
+std::to_chars into a large reusable buffer that is written with few system
+calls.
+**/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+//! Output formats for matchings.
+enum class MatchingFormat {
+  //! "p edge" line followed by one "e" line per matching edge (1-based ids)
+  dimacs,
+  //! 8 byte magic "EDMATCH1", number of nodes, number of edges, then one pair
+  //! of 0-based node ids per edge (all 64-bit, native byte order)
+  binary
+};
+
+/**
+   @class BufferedWriter
+
+   @brief Collects output in a buffer and writes it to a file descriptor once
+the buffer is full (and on @c flush() / destruction).
+**/
+class BufferedWriter {
+public:
+  /** @brief Writes to standard output. **/
+  BufferedWriter();
+
+  /** @brief Creates (or truncates) @c filename and writes to it. **/
+  explicit BufferedWriter(const std::string &filename);
+
+  ~BufferedWriter();
+
+  BufferedWriter(BufferedWriter const &) = delete;
+  BufferedWriter &operator=(BufferedWriter const &) = delete;
+
+  void write(char const *data, std::size_t const size);
+  void write(std::string const &str) { write(str.data(), str.size()); }
+
+  /** @brief Appends the decimal representation of @c value. **/
+  void write_decimal(std::uint64_t const value);
+
+  /** @brief Appends the raw bytes of @c value. **/
+  void write_binary(std::uint64_t const value);
+
+  /** @brief Writes out the buffer, throws on failure. **/
+  void flush();
+
+private:
+  static std::size_t constexpr buffer_size = std::size_t(1) << 20;
+
+  void reserve(std::size_t const size) {
+    if (_used + size > _buffer.size()) {
+      flush();
+    }
+  }
+
+  int _fd;
+  bool _owns_fd;
+  std::vector<char> _buffer;
+  std::size_t _used = 0;
+};
+
+/**
+   @brief Writes @c matching in the given format.
+**/
+void write_matching(BufferedWriter &writer, Matching const &matching,
+                    MatchingFormat const format = MatchingFormat::dimacs);
+
+} // namespace ED
+
+#endif /* MATCHING_WRITER_HPP */
@@ -1,564 +1,785 @@
 #include "maximum_cardinality_matching.hpp"
+#include "bipartite_matching.hpp"
+#include "certificate.hpp"
+#include "components.hpp"
+#include "csr_graph.hpp"
 #include "graph.hpp"
+#include "kernel.hpp"
+#include "matching.hpp"
+#include "parallel.hpp"
+#include "parallel_matching.hpp"
+#include "phase_matching.hpp"
+#include "solver_state.hpp"
+#include "stats.hpp"
+#include <algorithm>
 #include <cassert>
-#include <iostream>
-#include <list>
-#include <memory>
+#include <cstring>
+#include <limits>
 #include <optional>
-#include <unordered_map>
-#include <unordered_set>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 using Edge = std::pair<ED::NodeId, ED::NodeId>;
+using ED::Matching;
 using ED::NodeId;
+using ED::SolverState;
 
 enum MatchingExtensionResult { EXTENDED, FRUSTRATED, NOEXPOSEDNODE };
 
-struct Pseudonode {
-  // The nodes that the pseudonode consists of
-  std::shared_ptr<std::vector<NodeId>> nodes =
-      std::make_shared<std::vector<NodeId>>();
-  // The node of the pseudonode that is connected via an edge to the predecessor
-  std::shared_ptr<NodeId> root;
-  // The index of the cycle in contraction_cycle_history which was contracted to
-  // this pseudonodes
-  std::shared_ptr<size_t> cycle_idx;
+// Marks a sub-blossom of a cycle that is a single node
+constexpr size_t no_cycle = std::numeric_limits<size_t>::max();
+
+// The edges of all cycles contracted in the current tree, stored back to back
+// in one array so that later trees reuse the memory. Edge j of a cycle leads
+// from sub-blossom j to sub-blossom j + 1 (modulo the cycle length), where
+// sub-blossom 0 contains the base of the cycle. For each edge, the cycle that
+// created sub-blossom j is stored as well (no_cycle for a single node).
+class ContractionCycleHistory {
+public:
+  // Read-only view of the edges of one cycle
+  class Cycle {
+  public:
+    Cycle(Edge const *begin, Edge const *end, size_t const *sub_blossoms)
+        : _begin(begin), _end(end), _sub_blossoms(sub_blossoms) {}
+    Edge const *begin() const { return _begin; }
+    Edge const *end() const { return _end; }
+    size_t size() const { return static_cast<size_t>(_end - _begin); }
+    Edge const &front() const { return *_begin; }
+    Edge const &operator[](size_t const idx) const { return _begin[idx]; }
+    size_t sub_blossom(size_t const idx) const { return _sub_blossoms[idx]; }
+
+  private:
+    Edge const *_begin;
+    Edge const *_end;
+    size_t const *_sub_blossoms;
+  };
+
+  void clear() {
+    _edges.clear();
+    _sub_blossoms.clear();
+    _offsets.assign(1, 0);
+  }
+  size_t size() const { return _offsets.size() - 1; }
+  Cycle operator[](size_t const cycle_idx) const {
+    return Cycle(_edges.data() + _offsets[cycle_idx],
+                 _edges.data() + _offsets[cycle_idx + 1],
+                 _sub_blossoms.data() + _offsets[cycle_idx]);
+  }
+  Cycle back() const { return (*this)[size() - 1]; }
+
+  // Edges added after the last cycle form the next cycle once it is closed
+  void add_edge(Edge const &edge, size_t const sub_blossom) {
+    _edges.push_back(edge);
+    _sub_blossoms.push_back(sub_blossom);
+  }
+  void close_cycle() { _offsets.push_back(_edges.size()); }
+
+private:
+  std::vector<Edge> _edges;
+  std::vector<size_t> _sub_blossoms;
+  std::vector<size_t> _offsets{0};
 };
 
-// Returns a pseudonode that arises from merging a and b, where root and
-// cycle_idx of the new pseudonode are set to the parameters
-Pseudonode
-merge_pseudonodes(Pseudonode &a, Pseudonode &b, NodeId root, size_t cycle_idx,
-                  std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  assert(a.nodes and b.nodes);
-  if (a.nodes->size() < b.nodes->size()) {
-    return merge_pseudonodes(b, a, root, cycle_idx, pseudonodes);
-  }
-  for (NodeId node_id : *b.nodes) {
-    a.nodes->push_back(node_id);
-    pseudonodes[node_id] = a;
-  }
-  *a.root = root;
-  *a.cycle_idx = cycle_idx;
-  return a;
-}
+// A piece of an augmenting path inside a blossom: the even length alternating
+// path from node_id to the base of the blossom created by cycle cycle_idx
+// (just node_id for no_cycle), in reverse order if reversed is set. If
+// chain_end is not no_cycle, the sub-blossom of cycle_idx that contains
+// node_id is stored at chain_end - 1 in the sub-blossom chain of the
+// workspace, preceded by the smaller ones that contain node_id.
+struct PathSegment {
+  NodeId node_id;
+  size_t cycle_idx;
+  bool reversed;
+  size_t chain_end;
+};
 
-// Adds a node to the pseudonode
-void add_node_to_pseudonode(
-    Pseudonode &pseudonode, NodeId node_id,
-    std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  assert(pseudonodes.count(node_id) == 0);
-  pseudonode.nodes->push_back(node_id);
-  pseudonodes[node_id] = pseudonode;
-}
+// An even node whose neighbors remain to be scanned, starting at the neighbor
+// with index next
+struct FrontierEntry {
+  NodeId node_id;
+  size_t next;
+};
+
+// Counters and timers of the tree search, only updated if ED_STATS is set
+struct SearchStats {
+  size_t edges_scanned = 0;
+  size_t blossoms_shrunk = 0;
+  size_t max_blossom_depth = 0;
+  double shrink_seconds = 0;
+  double augment_seconds = 0;
+};
+
+// Memory for growing alternating trees, kept across trees so that growing a
+// tree does not allocate once the buffers are large enough
+struct TreeWorkspace {
+  std::vector<FrontierEntry> frontier;
+  ContractionCycleHistory contraction_cycle_history;
+  std::vector<Edge> cycle_part1;
+  std::vector<Edge> cycle_part2;
+  std::vector<NodeId> odd_nodes;
+  std::vector<PathSegment> segments;
+  std::vector<PathSegment> pieces;
+  // Cycles of the nested sub-blossoms containing a node, innermost first
+  std::vector<size_t> sub_blossom_chain;
+  std::vector<NodeId> augmenting_path;
+  // Nesting depth of the blossom created by each cycle (ED_STATS only)
+  std::vector<size_t> cycle_depths;
+  SearchStats stats;
+};
 
 // Gets the root of a node, i.e. the root of the pseudonode in which the node is
 // contained if it is contained in a pseudonode, or the node itself otherwise
-NodeId node_root(NodeId node_id,
-                 const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  if (pseudonodes.count(node_id) > 0) {
-    return *pseudonodes.at(node_id).root;
-  } else {
-    return node_id;
-  }
+NodeId node_root(NodeId node_id, const SolverState &state) {
+  return state.blossoms().base(node_id);
 }
 
-size_t node_dist(NodeId node_id,
-                 const std::unordered_map<NodeId, size_t> &node_dists,
-                 const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  return node_dists.at(node_root(node_id, pseudonodes));
+size_t node_dist(NodeId node_id, const SolverState &state) {
+  NodeId const root = node_root(node_id, state);
+  assert(state.has_dist(root));
+  return state.dist(root);
 }
 
-NodeId predecessor(NodeId node_id,
-                   const std::unordered_map<NodeId, NodeId> &predecessors,
-                   const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  return predecessors.at(node_root(node_id, pseudonodes));
+NodeId predecessor(NodeId node_id, const SolverState &state) {
+  NodeId const root = node_root(node_id, state);
+  assert(state.has_dist(root));
+  return state.predecessor(root);
 }
 
-// Returns an exposed node if one exists or std::nullopt otherwise
-std::optional<NodeId>
-find_exposed_node(const Graph &matching_graph,
-                  std::unordered_set<NodeId> &removed_nodes) {
-  for (ED::NodeId node_id = 0; node_id < matching_graph.num_nodes();
-       ++node_id) {
-    if (matching_graph.node(node_id).neighbors().size() == 0 and
-        removed_nodes.count(node_id) == 0) {
+// Returns an exposed node that has not been removed if one exists or
+// std::nullopt otherwise. exposed_nodes holds candidates with the smallest id
+// at the back; candidates that have been matched or removed since they were
+// added are dropped here, so each node is looked at O(1) times in total.
+std::optional<NodeId> find_exposed_node(const Matching &matching,
+                                        const SolverState &state,
+                                        std::vector<NodeId> &exposed_nodes,
+                                        size_t &nodes_scanned) {
+  while (not exposed_nodes.empty()) {
+    NodeId const node_id = exposed_nodes.back();
+    ++nodes_scanned;
+    if (matching.is_exposed(node_id) and not state.is_removed(node_id)) {
       return node_id;
     }
+    exposed_nodes.pop_back();
   }
   return std::nullopt;
 }
 
 // Adds an edge to the alternating tree
-void add_edge_to_tree(const Edge &edge,
-                      std::unordered_map<NodeId, size_t> &node_dists,
-                      std::unordered_map<NodeId, NodeId> &predecessors,
-                      const std::unordered_map<NodeId, Pseudonode> &pseudonodes,
-                      std::unordered_set<NodeId> &covered_nodes) {
-  node_dists[edge.second] = node_dist(edge.first, node_dists, pseudonodes) + 1;
-  predecessors[edge.second] = edge.first;
-  covered_nodes.insert(edge.first);
-  covered_nodes.insert(edge.second);
+void add_edge_to_tree(const Edge &edge, SolverState &state) {
+  state.set_dist(edge.second, node_dist(edge.first, state) + 1);
+  state.set_predecessor(edge.second, edge.first);
+  state.cover(edge.first);
+  state.cover(edge.second);
 }
 
-// Adds edges adjacent to the node with id node_id to the edges_to_consider
-void add_adjacent_edges(
-    NodeId node_id, const Graph &graph, const Graph &matching_graph,
-    std::list<Edge> &edges_to_consider,
-    std::optional<std::list<Edge>::iterator> &good_edge,
-    const std::unordered_set<NodeId> &removed_nodes,
-    const std::unordered_set<NodeId> &covered_nodes,
-    const std::unordered_map<NodeId, size_t> &node_dists,
-    const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  assert(node_dist(node_id, node_dists, pseudonodes) % 2 == 0);
-  assert(removed_nodes.count(node_id) == 0);
+// Makes the even node node_id a part of the frontier. If it has an exposed
+// neighbor outside the tree, that neighbor is added to the tree instead and
+// returned as the end of an augmenting path.
+std::optional<NodeId> add_to_frontier(NodeId node_id, const CsrGraph &graph,
+                                      const Matching &matching,
+                                      TreeWorkspace &workspace,
+                                      SolverState &state) {
+  assert(node_dist(node_id, state) % 2 == 0);
+  assert(not state.is_removed(node_id));
   for (NodeId neighbor_id : graph.node(node_id).neighbors()) {
-    if (removed_nodes.count(neighbor_id) == 0 and
-        node_root(neighbor_id, pseudonodes) !=
-            node_root(node_id, pseudonodes)) {
-      if (covered_nodes.count(neighbor_id) != 0 and
-          node_dist(neighbor_id, node_dists, pseudonodes) % 2 == 0) {
-        edges_to_consider.emplace_back(node_id, neighbor_id);
-      }
-    }
-  }
-  for (NodeId neighbor_id : graph.node(node_id).neighbors()) {
-    if (removed_nodes.count(neighbor_id) == 0 and
-        node_root(neighbor_id, pseudonodes) !=
-            node_root(node_id, pseudonodes)) {
-      if (covered_nodes.count(neighbor_id) == 0 and
-          matching_graph.node(neighbor_id).neighbors().size() == 1) {
-        edges_to_consider.emplace_back(node_id, neighbor_id);
-      }
-    }
-  }
-  // Edges that yield an augmenting path
-  for (NodeId neighbor_id : graph.node(node_id).neighbors()) {
-    if (removed_nodes.count(neighbor_id) == 0 and
-        node_root(neighbor_id, pseudonodes) !=
-            node_root(node_id, pseudonodes)) {
-      if (covered_nodes.count(neighbor_id) == 0 and
-          matching_graph.node(neighbor_id).neighbors().size() == 0) {
-        edges_to_consider.emplace_back(node_id, neighbor_id);
-        good_edge = --edges_to_consider.end();
-      }
+    ED_STATS_ONLY(++workspace.stats.edges_scanned;)
+    if (matching.is_exposed(neighbor_id) and not state.has_dist(neighbor_id) and
+        not state.is_removed(neighbor_id)) {
+      add_edge_to_tree(Edge(node_id, neighbor_id), state);
+      return neighbor_id;
     }
   }
+  workspace.frontier.push_back(FrontierEntry{node_id, 0});
+  return std::nullopt;
 }
 
-// Returns the edges on the cycle created by an edge between v1 and v2 in the
-// given tree in the order of the path (unspecified direction) and the root node
-std::pair<std::vector<Edge>, NodeId>
-cycle_edges(NodeId v1, NodeId v2,
-            const std::unordered_map<NodeId, size_t> &node_dists,
-            const std::unordered_map<NodeId, NodeId> &predecessors,
-            const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
+// Appends the edges on the cycle created by an edge between v1 and v2 in the
+// given tree in the order of the path (unspecified direction) to the history
+// and returns the root node of the cycle
+NodeId add_cycle(NodeId v1, NodeId v2, TreeWorkspace &workspace,
+                 const SolverState &state) {
   NodeId initial_v1 = v1;
   NodeId initial_v2 = v2;
-  std::vector<Edge> part1;
-  std::vector<Edge> part2;
-
-  while (node_root(v1, pseudonodes) != node_root(v2, pseudonodes)) {
-    if (node_dist(v1, node_dists, pseudonodes) >
-        node_dist(v2, node_dists, pseudonodes)) {
-      assert(predecessors.count(node_root(v1, pseudonodes)) > 0);
-      assert(node_root(v1, pseudonodes) !=
-             predecessor(v1, predecessors, pseudonodes));
-      part1.emplace_back(node_root(v1, pseudonodes),
-                         predecessor(v1, predecessors, pseudonodes));
-      v1 = predecessor(v1, predecessors, pseudonodes);
+  std::vector<Edge> &part1 = workspace.cycle_part1;
+  std::vector<Edge> &part2 = workspace.cycle_part2;
+  part1.clear();
+  part2.clear();
+
+  while (node_root(v1, state) != node_root(v2, state)) {
+    if (node_dist(v1, state) > node_dist(v2, state)) {
+      assert(node_root(v1, state) != predecessor(v1, state));
+      part1.emplace_back(node_root(v1, state), predecessor(v1, state));
+      v1 = predecessor(v1, state);
     } else {
-      assert(predecessors.count(node_root(v1, pseudonodes)) > 0);
-      assert(predecessors.count(node_root(v2, pseudonodes)) > 0);
-      assert(predecessor(v2, predecessors, pseudonodes) !=
-             node_root(v2, pseudonodes));
-      part2.emplace_back(predecessor(v2, predecessors, pseudonodes),
-                         node_root(v2, pseudonodes));
-      v2 = predecessor(v2, predecessors, pseudonodes);
+      assert(predecessor(v2, state) != node_root(v2, state));
+      part2.emplace_back(predecessor(v2, state), node_root(v2, state));
+      v2 = predecessor(v2, state);
     }
   }
 
-  std::vector<Edge> edges;
-  edges.insert(edges.end(), part2.rbegin(), part2.rend());
-  assert(node_root(initial_v1, pseudonodes) !=
-         node_root(initial_v2, pseudonodes));
-  edges.emplace_back(initial_v2, initial_v1);
-  edges.insert(edges.end(), part1.begin(), part1.end());
-  assert(edges.size() % 2 == 1);
+  ContractionCycleHistory &history = workspace.contraction_cycle_history;
+  ED::BlossomUnionFind const &blossoms = state.blossoms();
+  auto const add_edge = [&](Edge const &edge) {
+    history.add_edge(edge, blossoms.in_blossom(edge.first)
+                               ? blossoms.cycle_idx(edge.first)
+                               : no_cycle);
+  };
+  for (auto edge_iter = part2.rbegin(); edge_iter != part2.rend();
+       ++edge_iter) {
+    add_edge(*edge_iter);
+  }
+  assert(node_root(initial_v1, state) != node_root(initial_v2, state));
+  add_edge(Edge(initial_v2, initial_v1));
+  for (Edge const &edge : part1) {
+    add_edge(edge);
+  }
+  history.close_cycle();
+  assert(history.back().size() % 2 == 1);
 
-  return std::pair<std::vector<Edge>, NodeId>(std::move(edges),
-                                              node_root(v1, pseudonodes));
+  return node_root(v1, state);
 }
 
-// Extends the alternating tree and returns the second end node of an augmenting
-// path, if one was found
-std::optional<NodeId>
-extend_tree(const Edge &edge, const Graph &graph, const Graph &matching_graph,
-            std::unordered_map<NodeId, Pseudonode> &pseudonodes,
-            std::vector<std::vector<Edge>> &contraction_cycle_history,
-            std::unordered_map<NodeId, size_t> &first_cycle,
-            std::unordered_map<size_t, size_t> &larger_cycle,
-            std::unordered_map<NodeId, size_t> &node_dists,
-            std::unordered_map<NodeId, NodeId> &predecessors,
-            std::list<Edge> &edges_to_consider,
-            std::optional<std::list<Edge>::iterator> &good_edge,
-            const std::unordered_set<NodeId> &removed_nodes,
-            std::unordered_set<NodeId> &covered_nodes) {
-  assert(node_dist(edge.first, node_dists, pseudonodes) % 2 == 0);
-  assert(removed_nodes.count(edge.first) == 0);
-  assert(removed_nodes.count(edge.second) == 0);
-  if (node_dists.count(edge.second) == 0 and
-      matching_graph.node(edge.second).neighbors().size() == 0) {
+// Extends the alternating tree by the edge from an even node and returns the
+// second end node of an augmenting path, if one was found
+std::optional<NodeId> extend_tree(const Edge &edge, const CsrGraph &graph,
+                                  const Matching &matching,
+                                  TreeWorkspace &workspace,
+                                  SolverState &state) {
+  assert(node_dist(edge.first, state) % 2 == 0);
+  assert(not state.is_removed(edge.first));
+  if (state.is_removed(edge.second) or
+      node_root(edge.first, state) == node_root(edge.second, state)) {
+    return std::nullopt;
+  }
+  if (not state.has_dist(edge.second) and matching.is_exposed(edge.second)) {
     // Found an M-augmenting path
-    add_edge_to_tree(edge, node_dists, predecessors, pseudonodes,
-                     covered_nodes);
+    add_edge_to_tree(edge, state);
     return edge.second;
-  } else if (node_dists.count(edge.second) == 0) {
+  } else if (not state.has_dist(edge.second)) {
     // We can extend the tree
-    add_edge_to_tree(edge, node_dists, predecessors, pseudonodes,
-                     covered_nodes);
-    Edge matching_edge(edge.second,
-                       matching_graph.node(edge.second).neighbors().front());
-    add_edge_to_tree(matching_edge, node_dists, predecessors, pseudonodes,
-                     covered_nodes);
-    add_adjacent_edges(matching_edge.second, graph, matching_graph,
-                       edges_to_consider, good_edge, removed_nodes,
-                       covered_nodes, node_dists, pseudonodes);
-  } else if (node_dist(edge.second, node_dists, pseudonodes) % 2 == 0 and
-             node_root(edge.first, pseudonodes) !=
-                 node_root(edge.second, pseudonodes)) {
-    auto cycle_result = cycle_edges(edge.first, edge.second, node_dists,
-                                    predecessors, pseudonodes);
-    assert(cycle_result.first.size() % 2 == 1);
+    add_edge_to_tree(edge, state);
+    Edge matching_edge(edge.second, matching.mate(edge.second));
+    add_edge_to_tree(matching_edge, state);
+    return add_to_frontier(matching_edge.second, graph, matching, workspace,
+                           state);
+  } else if (node_dist(edge.second, state) % 2 == 0) {
     // We need to contract the cycle
-    contraction_cycle_history.push_back(std::move(cycle_result.first));
-
-    std::vector<NodeId> odd_nodes;
-    for (size_t edge_idx = 0;
-         edge_idx < contraction_cycle_history.back().size(); ++edge_idx) {
-      if (node_dist(contraction_cycle_history.back()[edge_idx].first,
-                    node_dists, pseudonodes) %
-              2 ==
-          1) {
-        odd_nodes.push_back(contraction_cycle_history.back()[edge_idx].first);
+    ED_STATS_ONLY(ED::ScopedTimer const timer(workspace.stats.shrink_seconds);)
+    NodeId const cycle_root =
+        add_cycle(edge.first, edge.second, workspace, state);
+    ContractionCycleHistory const &history =
+        workspace.contraction_cycle_history;
+    ContractionCycleHistory::Cycle const cycle = history.back();
+
+    std::vector<NodeId> &odd_nodes = workspace.odd_nodes;
+    odd_nodes.clear();
+    for (Edge const &cycle_edge : cycle) {
+      if (node_dist(cycle_edge.first, state) % 2 == 1) {
+        odd_nodes.push_back(cycle_edge.first);
       }
     }
 
-    Pseudonode new_pseudonode;
-    new_pseudonode.root = std::make_shared<NodeId>(cycle_result.second);
-    new_pseudonode.cycle_idx =
-        std::make_shared<size_t>(contraction_cycle_history.size() - 1);
-    for (Edge edge : contraction_cycle_history.back()) {
-      if (pseudonodes.count(edge.first) == 0) {
-        add_node_to_pseudonode(new_pseudonode, edge.first, pseudonodes);
-        first_cycle[edge.first] = contraction_cycle_history.size() - 1;
+    // Shrink the cycle: all of its nodes (and the blossoms they are contained
+    // in) are united into one set whose base is the root of the cycle
+    size_t const cycle_idx = history.size() - 1;
+    ED::BlossomUnionFind &blossoms = state.blossoms();
+    for (size_t position = 0; position < cycle.size(); ++position) {
+      if (cycle.sub_blossom(position) == no_cycle) {
+        state.set_first_cycle(cycle[position].first, cycle_idx, position);
       } else {
-        larger_cycle[*pseudonodes[edge.first].cycle_idx] =
-            contraction_cycle_history.size() - 1;
-        new_pseudonode = merge_pseudonodes(
-            new_pseudonode, pseudonodes[edge.first], *new_pseudonode.root,
-            contraction_cycle_history.size() - 1, pseudonodes);
+        state.set_larger_cycle(cycle.sub_blossom(position), cycle_idx,
+                               position);
       }
     }
-    for (size_t edge_idx = 0;
-         edge_idx < contraction_cycle_history.back().size(); ++edge_idx) {
-      assert(node_dist(contraction_cycle_history.back()[edge_idx].first,
-                       node_dists, pseudonodes) %
-                 2 ==
-             0);
+    for (Edge const &cycle_edge : cycle) {
+      blossoms.unite(cycle_root, cycle_edge.first);
+    }
+    blossoms.set_blossom(cycle_root, cycle_root, cycle_idx);
+#if ED_STATS
+    size_t depth = 1;
+    for (size_t position = 0; position < cycle.size(); ++position) {
+      size_t const sub_blossom = cycle.sub_blossom(position);
+      if (sub_blossom != no_cycle) {
+        depth = std::max(depth, workspace.cycle_depths[sub_blossom] + 1);
+      }
+    }
+    workspace.cycle_depths.push_back(depth);
+    ++workspace.stats.blossoms_shrunk;
+    workspace.stats.max_blossom_depth =
+        std::max(workspace.stats.max_blossom_depth, depth);
+#endif
+    for (size_t edge_idx = 0; edge_idx < cycle.size(); ++edge_idx) {
+      assert(node_dist(cycle[edge_idx].first, state) % 2 == 0);
     }
 
+    // The former odd nodes are even now and their neighbors have to be
+    // scanned
     for (NodeId node_id : odd_nodes) {
-      add_adjacent_edges(node_id, graph, matching_graph, edges_to_consider,
-                         good_edge, removed_nodes, covered_nodes, node_dists,
-                         pseudonodes);
+      std::optional<NodeId> const endpoint =
+          add_to_frontier(node_id, graph, matching, workspace, state);
+      if (endpoint) {
+        return endpoint;
+      }
     }
   }
   return std::nullopt;
 }
 
-// Unshrinks all cycles that have been created before max_cycle_idx such that
-// the node with id node_id is contained in the pseudonode after the cycle
-// contraction.
-// This is done from bottom to top, i.e. we unshrink the first cycle which
-// created a pseudonode where the node is contained and then proceed with the
-// next larger cycle until no larger cycle that was created before max_cycle_idx
-// exists
-void unshrink_subcycles(
-    NodeId node_id, size_t max_cycle_idx,
-    const std::vector<std::vector<Edge>> &contraction_cycle_history,
-    const std::unordered_map<NodeId, size_t> &first_cycle,
-    const std::unordered_map<size_t, size_t> &larger_cycle,
-    Graph &new_matching_graph, const Graph &matching_graph,
-    const std::unordered_map<NodeId, size_t> &node_dists,
-    const std::unordered_map<NodeId, Pseudonode> &pseudonodes);
-
-// Unshrinks a cycle by finding a node with degree 1 and adding each second edge
-// from the cycle, recursively calls unshrink_subcycles so that all cycles are
-// unshrinked
-bool unshrink_cycle(
-    const std::vector<std::vector<Edge>> &contraction_cycle_history,
-    size_t cycle_idx, const std::unordered_map<NodeId, size_t> &first_cycle,
-    const std::unordered_map<size_t, size_t> &larger_cycle,
-    Graph &new_matching_graph, const Graph &matching_graph,
-    const std::unordered_map<NodeId, size_t> &node_dists,
-    const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  const std::vector<Edge> &cycle = contraction_cycle_history.at(cycle_idx);
-  // std::cout << "Unshrink cycle of size " << cycle.size() << std::endl;
-  assert(node_dist(cycle.front().first, node_dists, pseudonodes) % 2 == 0);
-  // Find node from the cycle that already has degree 1
-  bool found_node_with_degree_1 = false;
-  size_t edge_with_first_node_degree_1_idx = 0;
-  for (size_t edge_id_idx = 0; edge_id_idx < cycle.size(); ++edge_id_idx) {
-    assert(matching_graph.num_edges() > 0 or true);
-    if (new_matching_graph.node(cycle[edge_id_idx].first).neighbors().size() ==
-        1) {
-      edge_with_first_node_degree_1_idx = edge_id_idx;
-      found_node_with_degree_1 = true;
-      break;
-    } else if (new_matching_graph.node(cycle[edge_id_idx].second)
-                   .neighbors()
-                   .size() == 1) {
-      edge_with_first_node_degree_1_idx = (edge_id_idx + 1) % cycle.size();
-      found_node_with_degree_1 = true;
-      break;
+// Appends the even length alternating path from node_id to the base of the
+// blossom created by cycle cycle_idx to the augmenting path. Nested blossoms
+// are expanded top-down with an explicit stack of path segments, and only the
+// sub-blossoms the path passes through are visited. The chain of sub-blossoms
+// containing a node is climbed once via the larger cycles and then reused on
+// every level below, so the cost is linear in the length of the path plus the
+// nesting depth of the blossoms it enters.
+void append_blossom_path(NodeId node_id, size_t cycle_idx,
+                         TreeWorkspace &workspace, const SolverState &state) {
+  std::vector<PathSegment> &segments = workspace.segments;
+  std::vector<PathSegment> &pieces = workspace.pieces;
+  std::vector<size_t> &chain = workspace.sub_blossom_chain;
+  segments.assign(1, PathSegment{node_id, cycle_idx, false, no_cycle});
+  chain.clear();
+
+  while (not segments.empty()) {
+    PathSegment const segment = segments.back();
+    segments.pop_back();
+    if (segment.cycle_idx == no_cycle) {
+      workspace.augmenting_path.push_back(segment.node_id);
+      continue;
+    }
+
+    // Find the sub-blossom of the cycle that contains the node
+    size_t sub_blossom = no_cycle;
+    size_t chain_end = no_cycle;
+    size_t position = state.first_cycle_position(segment.node_id);
+    if (state.first_cycle(segment.node_id) != segment.cycle_idx) {
+      chain_end = segment.chain_end;
+      if (chain_end == no_cycle) {
+        sub_blossom = state.first_cycle(segment.node_id);
+        chain.push_back(sub_blossom);
+        while (state.larger_cycle(sub_blossom) != segment.cycle_idx) {
+          sub_blossom = state.larger_cycle(sub_blossom);
+          chain.push_back(sub_blossom);
+        }
+        chain_end = chain.size();
+      }
+      sub_blossom = chain[chain_end - 1];
+      assert(state.larger_cycle(sub_blossom) == segment.cycle_idx);
+      position = state.larger_cycle_position(sub_blossom);
+      --chain_end;
+    }
+
+    // Edge j of the cycle is a matching edge iff j is odd, so the path leaves
+    // sub-blossom j through edge j for odd j and through edge j - 1 otherwise.
+    // Each sub-blossom on the way is entered at its base and left through an
+    // arbitrary node, or vice versa.
+    ContractionCycleHistory::Cycle const cycle =
+        workspace.contraction_cycle_history[segment.cycle_idx];
+    size_t const length = cycle.size();
+    pieces.clear();
+    pieces.push_back(
+        PathSegment{segment.node_id, sub_blossom, false, chain_end});
+    if (position % 2 == 1) {
+      for (size_t idx = position; idx + 2 <= length; idx += 2) {
+        pieces.push_back(PathSegment{cycle[idx + 1].first,
+                                     cycle.sub_blossom(idx + 1), true,
+                                     no_cycle});
+        pieces.push_back(PathSegment{cycle[idx + 1].second,
+                                     cycle.sub_blossom((idx + 2) % length),
+                                     false, no_cycle});
+      }
+    } else {
+      for (size_t idx = position; idx >= 2; idx -= 2) {
+        pieces.push_back(PathSegment{cycle[idx - 2].second,
+                                     cycle.sub_blossom(idx - 1), true,
+                                     no_cycle});
+        pieces.push_back(PathSegment{cycle[idx - 2].first,
+                                     cycle.sub_blossom(idx - 2), false,
+                                     no_cycle});
+      }
+    }
+
+    // Push the pieces such that the next one to be emitted is on top; a
+    // reversed segment emits its pieces in reverse order, each reversed
+    if (segment.reversed) {
+      for (PathSegment piece : pieces) {
+        piece.reversed = not piece.reversed;
+        segments.push_back(piece);
+      }
+    } else {
+      segments.insert(segments.end(), pieces.rbegin(), pieces.rend());
     }
-    assert(
-        new_matching_graph.node(cycle[edge_id_idx].first).neighbors().size() <=
-        1);
-    assert(
-        new_matching_graph.node(cycle[edge_id_idx].second).neighbors().size() <=
-        1);
-  }
-  assert(found_node_with_degree_1);
-
-  // Add every second edge from the contracted cycle
-  for (size_t edge_idx = edge_with_first_node_degree_1_idx % 2;
-       edge_idx < edge_with_first_node_degree_1_idx; edge_idx += 2) {
-    assert(new_matching_graph.node(cycle[edge_idx].first).neighbors().size() ==
-           0);
-    assert(new_matching_graph.node(cycle[edge_idx].second).neighbors().size() ==
-           0);
-    new_matching_graph.add_edge(cycle[edge_idx].first, cycle[edge_idx].second);
-    unshrink_subcycles(cycle[edge_idx].first, cycle_idx,
-                       contraction_cycle_history, first_cycle, larger_cycle,
-                       new_matching_graph, matching_graph, node_dists,
-                       pseudonodes);
-    unshrink_subcycles(cycle[edge_idx].second, cycle_idx,
-                       contraction_cycle_history, first_cycle, larger_cycle,
-                       new_matching_graph, matching_graph, node_dists,
-                       pseudonodes);
-  }
-  for (size_t edge_idx = edge_with_first_node_degree_1_idx + 1;
-       edge_idx < cycle.size(); edge_idx += 2) {
-    assert(new_matching_graph.node(cycle[edge_idx].first).neighbors().size() ==
-           0);
-    assert(new_matching_graph.node(cycle[edge_idx].second).neighbors().size() ==
-           0);
-    new_matching_graph.add_edge(cycle[edge_idx].first, cycle[edge_idx].second);
-    unshrink_subcycles(cycle[edge_idx].first, cycle_idx,
-                       contraction_cycle_history, first_cycle, larger_cycle,
-                       new_matching_graph, matching_graph, node_dists,
-                       pseudonodes);
-    unshrink_subcycles(cycle[edge_idx].second, cycle_idx,
-                       contraction_cycle_history, first_cycle, larger_cycle,
-                       new_matching_graph, matching_graph, node_dists,
-                       pseudonodes);
   }
-  return true;
 }
 
-void unshrink_subcycles(
-    NodeId node_id, size_t max_cycle_idx,
-    const std::vector<std::vector<Edge>> &contraction_cycle_history,
-    const std::unordered_map<NodeId, size_t> &first_cycle,
-    const std::unordered_map<size_t, size_t> &larger_cycle,
-    Graph &new_matching_graph, const Graph &matching_graph,
-    const std::unordered_map<NodeId, size_t> &node_dists,
-    const std::unordered_map<NodeId, Pseudonode> &pseudonodes) {
-  if (first_cycle.count(node_id) == 0) {
-    return;
-  }
-  size_t current_cycle = first_cycle.at(node_id);
-  while (current_cycle < max_cycle_idx) {
-    unshrink_cycle(contraction_cycle_history, current_cycle, first_cycle,
-                   larger_cycle, new_matching_graph, matching_graph, node_dists,
-                   pseudonodes);
-    if (larger_cycle.count(current_cycle) == 0) {
+// Augments the matching along the path from the exposed node endpoint, which
+// has just been added to the tree, to the root
+void augment_to_root(NodeId endpoint, NodeId root, Matching &matching,
+                     TreeWorkspace &workspace, const SolverState &state) {
+  std::vector<NodeId> &path = workspace.augmenting_path;
+  path.clear();
+  path.push_back(endpoint);
+  NodeId node_id = predecessor(endpoint, state);
+  while (true) {
+    ED::BlossomUnionFind const &blossoms = state.blossoms();
+    append_blossom_path(node_id,
+                        blossoms.in_blossom(node_id)
+                            ? blossoms.cycle_idx(node_id)
+                            : no_cycle,
+                        workspace, state);
+    NodeId const base = node_root(node_id, state);
+    if (base == root) {
       break;
     }
-    current_cycle = larger_cycle.at(current_cycle);
+    // The matching edge into the blossom leads to an odd node
+    NodeId const odd_node_id = predecessor(base, state);
+    assert(matching.mate(base) == odd_node_id);
+    path.push_back(odd_node_id);
+    node_id = predecessor(odd_node_id, state);
   }
+  matching.augment(path);
 }
 
-MatchingExtensionResult
-extend_matching(const Graph &graph, const Graph &matching_graph,
-                Graph &new_matching_graph,
-                std::unordered_set<NodeId> &covered_nodes,
-                std::unordered_set<NodeId> &removed_nodes) {
+// Grows an alternating tree from an exposed node and, if an augmenting path is
+// found, augments the matching in place
+MatchingExtensionResult extend_matching(const CsrGraph &graph,
+                                        Matching &matching, SolverState &state,
+                                        TreeWorkspace &workspace,
+                                        std::vector<NodeId> &exposed_nodes,
+                                        size_t &nodes_scanned) {
   // Find an M-exposed node
   std::optional<ED::NodeId> exposed_node_id =
-      find_exposed_node(matching_graph, removed_nodes);
+      find_exposed_node(matching, state, exposed_nodes, nodes_scanned);
   if (!exposed_node_id) {
     return NOEXPOSEDNODE;
   }
 
-  // Contains the contracted set of which a contracted node is a part of
-  std::unordered_map<NodeId, Pseudonode> pseudonodes;
-
-  // Initialize the edges to consider in each tree growth step
-  std::list<Edge> edges_to_consider;
-  std::optional<std::list<Edge>::iterator> good_edge;
+  // Forget distances, predecessors and pseudonodes of the previous tree
+  state.begin_tree();
+  workspace.frontier.clear();
+  workspace.contraction_cycle_history.clear();
+  ED_STATS_ONLY(workspace.cycle_depths.clear();)
 
   // Distance for each node from the root
-  std::unordered_map<NodeId, size_t> node_dists;
-  node_dists[*exposed_node_id] = 0;
-
-  add_adjacent_edges(*exposed_node_id, graph, matching_graph, edges_to_consider,
-                     good_edge, removed_nodes, covered_nodes, node_dists,
-                     pseudonodes);
-
-  // Contraction cycle history
-  std::vector<std::vector<Edge>> contraction_cycle_history;
-
-  std::unordered_map<NodeId, size_t> first_cycle;
-  std::unordered_map<size_t, size_t> larger_cycle;
-
-  std::unordered_map<NodeId, NodeId> predecessors;
-  predecessors[*exposed_node_id] = *exposed_node_id;
-
-  while (edges_to_consider.size() > 0) {
-    Edge &edge = good_edge ? **good_edge : edges_to_consider.back();
-    auto edge_iter = good_edge ? *good_edge : --edges_to_consider.end();
-    std::optional<NodeId> augmenting_path_endpoint = extend_tree(
-        edge, graph, matching_graph, pseudonodes, contraction_cycle_history,
-        first_cycle, larger_cycle, node_dists, predecessors, edges_to_consider,
-        good_edge, removed_nodes, covered_nodes);
-    if (augmenting_path_endpoint) {
-      NodeId current_node = *augmenting_path_endpoint;
-      // Found an augmenting path
-      while (true) {
-        assert(node_dist(current_node, node_dists, pseudonodes) % 2 == 1);
-        assert(covered_nodes.count(node_root(current_node, pseudonodes)) == 1);
-        assert(covered_nodes.count(
-                   predecessor(current_node, predecessors, pseudonodes)) == 1);
-        new_matching_graph.add_edge(
-            node_root(current_node, pseudonodes),
-            predecessor(current_node, predecessors, pseudonodes));
-
-        unshrink_subcycles(predecessor(current_node, predecessors, pseudonodes),
-                           contraction_cycle_history.size(),
-                           contraction_cycle_history, first_cycle, larger_cycle,
-                           new_matching_graph, matching_graph, node_dists,
-                           pseudonodes);
-
-        if (node_root(predecessor(current_node, predecessors, pseudonodes),
-                      pseudonodes) == *exposed_node_id) {
-          break;
-        }
-
-        current_node = predecessor(current_node, predecessors, pseudonodes);
-        current_node = predecessor(current_node, predecessors, pseudonodes);
-      }
-
-      for (NodeId node_id = 0; node_id < matching_graph.num_nodes();
-           ++node_id) {
-        if (matching_graph.node(node_id).neighbors().size() > 0 and
-            new_matching_graph.node(node_id).neighbors().size() == 0) {
-          if (matching_graph.node(node_id).neighbors().front() < node_id) {
-            if (new_matching_graph
-                    .node(matching_graph.node(node_id).neighbors().front())
-                    .neighbors()
-                    .size() != 0) {
-            }
-            assert(new_matching_graph
-                       .node(matching_graph.node(node_id).neighbors().front())
-                       .neighbors()
-                       .size() == 0);
-            new_matching_graph.add_edge(
-                node_id, matching_graph.node(node_id).neighbors().front());
-          }
-        }
-      }
-      return EXTENDED;
+  state.set_dist(*exposed_node_id, 0);
+  state.set_predecessor(*exposed_node_id, *exposed_node_id);
+
+  std::optional<NodeId> augmenting_path_endpoint = add_to_frontier(
+      *exposed_node_id, graph, matching, workspace, state);
+
+  // Scan the neighbors of the most recently added even node first
+  while (not augmenting_path_endpoint and not workspace.frontier.empty()) {
+    FrontierEntry &entry = workspace.frontier.back();
+    ED::NeighborRange const neighbors = graph.node(entry.node_id).neighbors();
+    if (entry.next == neighbors.size()) {
+      workspace.frontier.pop_back();
+      continue;
     }
-    edges_to_consider.erase(edge_iter);
+    Edge const edge(entry.node_id, neighbors[entry.next++]);
+    ED_STATS_ONLY(++workspace.stats.edges_scanned;)
+    augmenting_path_endpoint =
+        extend_tree(edge, graph, matching, workspace, state);
+  }
+  if (augmenting_path_endpoint) {
+    ED_STATS_ONLY(ED::ScopedTimer const timer(workspace.stats.augment_seconds);)
+    augment_to_root(*augmenting_path_endpoint, *exposed_node_id, matching,
+                    workspace, state);
+    return EXTENDED;
   }
 
-  covered_nodes.insert(*exposed_node_id);
+  state.cover(*exposed_node_id);
 
   return FRUSTRATED;
 }
 
-Graph compute_maximum_cardinality_matching(const Graph &graph) {
-  std::shared_ptr<ED::Graph> current_matching =
-      std::make_shared<ED::Graph>(graph.num_nodes());
-  ED::Graph &greedy_matching = *current_matching;
-  for (ED::NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
-    if (greedy_matching.node(node_id).neighbors().empty()) {
-      for (ED::NodeId neighbor_id : graph.node(node_id).neighbors()) {
-        if (greedy_matching.node(neighbor_id).neighbors().empty()) {
-          greedy_matching.add_edge(node_id, neighbor_id);
-          break; // Do not add more edges incident to this node!
-        }
-      }
+// Extends the matching one alternating tree at a time, frustrated trees are
+// removed from the graph. Fills in the number of nodes looked at while
+// searching for roots and the search statistics of the report.
+void grow_by_edmonds(const CsrGraph &graph, Matching &matching,
+                     MatchingReport *report) {
+  ED::Stopwatch const stopwatch;
+  size_t frustrated = 0;
+  size_t nodes_scanned = 0;
+
+  // Matched nodes stay matched, so the exposed nodes are collected only once
+  std::vector<NodeId> exposed_nodes;
+  for (NodeId node_id = graph.num_nodes(); node_id-- > 0;) {
+    if (matching.is_exposed(node_id)) {
+      exposed_nodes.push_back(node_id);
     }
   }
 
-  size_t frustrated = 0;
-  std::unordered_set<NodeId> removed_nodes;
-
-  // Nodes covered by alternating tree
-  std::unordered_set<NodeId> covered_nodes;
-  while (removed_nodes.size() < graph.num_nodes()) {
-    std::shared_ptr<ED::Graph> new_matching =
-        std::make_shared<ED::Graph>(graph.num_nodes());
+  // Removed nodes, nodes covered by alternating trees and the per-tree data.
+  // The workspace belongs to the thread, so solving many small graphs in a
+  // row (components, batch mode) reuses its buffers.
+  SolverState state(graph.num_nodes());
+  thread_local TreeWorkspace workspace;
+  workspace.stats = SearchStats();
+  while (state.num_removed() < graph.num_nodes()) {
     MatchingExtensionResult result;
-    while ((result = extend_matching(graph, *current_matching, *new_matching,
-                                     covered_nodes, removed_nodes)) ==
+    while ((result = extend_matching(graph, matching, state, workspace,
+                                     exposed_nodes, nodes_scanned)) ==
            EXTENDED) {
-      if (current_matching->num_edges() >= new_matching->num_edges()) {
-        std::cout << "current_graph->num_edges(): "
-                  << current_matching->num_edges()
-                  << ", new_graph->num_edges(): " << new_matching->num_edges()
-                  << std::endl;
-      }
-      assert(current_matching->num_edges() < new_matching->num_edges());
-      current_matching = new_matching;
-      for (NodeId node_id = 0; node_id < current_matching->num_nodes();
-           ++node_id) {
-        assert(current_matching->node(node_id).neighbors().size() <= 1);
-      }
-      new_matching = std::make_shared<ED::Graph>(graph.num_nodes());
-      covered_nodes.clear();
+      state.clear_covered();
     }
     if (result == NOEXPOSEDNODE) {
       break;
     }
     ++frustrated;
-    for (NodeId node_id : covered_nodes) {
-      removed_nodes.insert(node_id);
+    // Without clearing, a run of frustrated trees walks all earlier ones again
+    for (NodeId node_id : state.covered_nodes()) {
+      state.remove(node_id);
     }
+    state.clear_covered();
   }
 
-  for (NodeId node_id = 0; node_id < current_matching->num_nodes(); ++node_id) {
-    assert(current_matching->node(node_id).neighbors().size() <= 1);
-    if (current_matching->node(node_id).neighbors().size() == 0) {
-      continue;
+  if (report != nullptr) {
+    report->root_nodes_scanned = nodes_scanned;
+#if ED_STATS
+    SearchStats const &stats = workspace.stats;
+    report->blossom_shrink_seconds = stats.shrink_seconds;
+    report->augment_seconds = stats.augment_seconds;
+    report->tree_growth_seconds =
+        stopwatch.seconds() - stats.shrink_seconds - stats.augment_seconds;
+    report->frustrated_trees = frustrated;
+    report->blossoms_shrunk = stats.blossoms_shrunk;
+    report->max_blossom_depth = stats.max_blossom_depth;
+    report->edges_scanned = stats.edges_scanned;
+#endif
+  }
+}
+
+// Debug builds check every result against a Tutte-Berge barrier, which takes
+// linear time and does not trust the engine that computed the matching
+[[maybe_unused]] bool is_certified_maximum(const CsrGraph &graph,
+                                           const Matching &matching) {
+  return ED::verify_maximum_matching(
+      graph, matching, ED::find_tutte_berge_barrier(graph, matching));
+}
+
+// Solves the graph as one problem, without splitting it into components
+Matching compute_on_whole_graph(const CsrGraph &graph,
+                                const MatchingOptions &options,
+                                MatchingReport *report) {
+  if (graph.num_edges() == 0) {
+    if (report != nullptr) {
+      report->engine = MatchingEngine::none;
+      report->num_components = 0;
     }
-    bool found = false;
-    for (NodeId neighbor_id : graph.node(node_id).neighbors()) {
-      if (neighbor_id == current_matching->node(node_id).neighbors().front()) {
-        found = true;
+    return Matching(graph.num_nodes());
+  }
+
+  // Bipartite graphs need no blossoms, so the O(n + m) test pays off
+  MatchingEngine engine = options.engine;
+  if (engine == MatchingEngine::parallel and options.num_threads <= 1) {
+    // On one thread, the rounds only do part of the sequential search's work
+    // less efficiently, so that search runs alone
+    engine = MatchingEngine::edmonds;
+  }
+  std::vector<std::uint8_t> sides;
+  if (engine == MatchingEngine::hopcroft_karp or options.detect_bipartite) {
+    if (ED::find_bipartition(graph, sides)) {
+      engine = MatchingEngine::hopcroft_karp;
+    } else if (engine == MatchingEngine::hopcroft_karp) {
+      throw std::runtime_error("Hopcroft-Karp needs a bipartite graph.");
+    }
+  }
+
+  ED::Stopwatch const stopwatch;
+  Matching matching(graph.num_nodes());
+  ED::initialize_matching(graph, matching, options.initializer, options.seed,
+                          options.num_threads);
+  if (report != nullptr) {
+    report->initial_matching_seconds = stopwatch.seconds();
+    report->engine = engine;
+    report->num_components = 1;
+    report->initial_matching_size = matching.num_edges();
+  }
+
+  if (engine == MatchingEngine::hopcroft_karp) {
+    ED::augment_hopcroft_karp(graph, sides, matching, options.num_threads);
+  } else if (engine == MatchingEngine::phases) {
+    ED::augment_by_phases(graph, matching);
+  } else if (engine == MatchingEngine::incremental) {
+    ED::IncrementalSearchStats const stats =
+        ED::augment_incrementally(graph, matching);
+    if (report != nullptr) {
+      report->rescanned_nodes = stats.num_rescanned;
+    }
+  } else {
+    if (engine == MatchingEngine::parallel) {
+      ED::augment_in_parallel(graph, matching, options.num_threads);
+    }
+    grow_by_edmonds(graph, matching, report);
+  }
+
+  if (report != nullptr) {
+    report->num_augmentations =
+        matching.num_edges() - report->initial_matching_size;
+  }
+  return matching;
+}
+
+Matching compute_maximum_cardinality_matching(const Graph &graph,
+                                              const MatchingOptions &options,
+                                              MatchingReport *report) {
+  return compute_maximum_cardinality_matching(CsrGraph(graph), options, report);
+}
+
+// Solves the components of the graph separately if there are several
+Matching compute_by_components(const CsrGraph &graph,
+                               const MatchingOptions &options,
+                               MatchingReport *report) {
+  if (not options.split_components) {
+    return compute_on_whole_graph(graph, options, report);
+  }
+  ED::Components const components = ED::find_components(graph);
+  std::vector<size_t> order;
+  for (size_t idx = 0; idx < components.num_components(); ++idx) {
+    if (components.num_edges[idx] > 0) {
+      order.push_back(idx);
+    }
+  }
+  if (order.size() <= 1) {
+    return compute_on_whole_graph(graph, options, report);
+  }
+
+  // Largest components first, so that no big one is started last and keeps
+  // a single thread busy while the others idle
+  std::stable_sort(order.begin(), order.end(),
+                   [&](size_t const a, size_t const b) {
+                     return components.num_edges[a] > components.num_edges[b];
+                   });
+  std::vector<std::optional<Matching>> matchings(order.size());
+  std::vector<MatchingReport> reports(order.size());
+  auto const solve = [&](size_t const order_idx, unsigned const num_threads) {
+    MatchingOptions component_options = options;
+    component_options.split_components = false;
+    component_options.num_threads = num_threads;
+    CsrGraph const subgraph =
+        ED::component_subgraph(graph, components, order[order_idx]);
+    matchings[order_idx] = compute_on_whole_graph(
+        subgraph, component_options, &reports[order_idx]);
+  };
+
+  // A component with most of the edges gets all threads to itself, the
+  // others are solved concurrently with one thread each
+  size_t first_shared = 0;
+  if (2 * components.num_edges[order.front()] > graph.num_edges()) {
+    solve(0, options.num_threads);
+    first_shared = 1;
+  }
+  ED::parallel_for(order.size() - first_shared, options.num_threads,
+                   [&](size_t const task_idx) {
+                     solve(first_shared + task_idx, 1);
+                   });
+
+  Matching matching(graph.num_nodes());
+  for (size_t order_idx = 0; order_idx < order.size(); ++order_idx) {
+    size_t const component_idx = order[order_idx];
+    Matching const &component_matching = *matchings[order_idx];
+    for (NodeId local_id = 0; local_id < component_matching.num_nodes();
+         ++local_id) {
+      NodeId const mate_id = component_matching.mate(local_id);
+      if (mate_id != ED::invalid_node_id and local_id < mate_id) {
+        matching.match(components.node(component_idx, local_id),
+                       components.node(component_idx, mate_id));
       }
     }
-    if (not found) {
-      std::cout << node_id << ", "
-                << current_matching->node(node_id).neighbors().front()
-                << std::endl;
+  }
+
+  if (report != nullptr) {
+    *report = MatchingReport();
+    report->engine = reports.front().engine;
+    report->num_components = order.size();
+    for (MatchingReport const &component_report : reports) {
+      report->initial_matching_size += component_report.initial_matching_size;
+      report->root_nodes_scanned += component_report.root_nodes_scanned;
+      report->num_augmentations += component_report.num_augmentations;
+      report->rescanned_nodes += component_report.rescanned_nodes;
+      report->initial_matching_seconds +=
+          component_report.initial_matching_seconds;
+      report->tree_growth_seconds += component_report.tree_growth_seconds;
+      report->blossom_shrink_seconds += component_report.blossom_shrink_seconds;
+      report->augment_seconds += component_report.augment_seconds;
+      report->frustrated_trees += component_report.frustrated_trees;
+      report->blossoms_shrunk += component_report.blossoms_shrunk;
+      report->max_blossom_depth = std::max(report->max_blossom_depth,
+                                           component_report.max_blossom_depth);
+      report->edges_scanned += component_report.edges_scanned;
+    }
+  }
+  return matching;
+}
+
+Matching compute_maximum_cardinality_matching(const CsrGraph &graph,
+                                              const MatchingOptions &options,
+                                              MatchingReport *report) {
+  if (not options.reduce_graph) {
+    Matching matching = compute_by_components(graph, options, report);
+    if (report != nullptr) {
+      report->kernel_num_nodes = graph.num_nodes();
+      report->kernel_num_edges = graph.num_edges();
+    }
+    assert(is_certified_maximum(graph, matching));
+    return matching;
+  }
+
+  // Folds can remove odd cycles, so the kernel may be bipartite even if the
+  // graph is not
+  if (options.engine == MatchingEngine::hopcroft_karp) {
+    std::vector<std::uint8_t> sides;
+    if (not ED::find_bipartition(graph, sides)) {
+      throw std::runtime_error("Hopcroft-Karp needs a bipartite graph.");
     }
-    assert(found);
   }
+  ED::Stopwatch const stopwatch;
+  ED::Kernel const kernel(graph);
+  double const reduction_seconds = stopwatch.seconds();
+  Matching const kernel_matching =
+      compute_by_components(kernel.graph(), options, report);
+  if (report != nullptr) {
+    report->reduction_seconds = reduction_seconds;
+    report->kernel_num_nodes = kernel.graph().num_nodes();
+    report->kernel_num_edges = kernel.graph().num_edges();
+  }
+  Matching matching = kernel.lift(kernel_matching);
+  assert(is_certified_maximum(graph, matching));
+  return matching;
+}
+
+bool parse_engine(char const *name, MatchingEngine &engine) {
+  if (std::strcmp(name, "edmonds") == 0) {
+    engine = MatchingEngine::edmonds;
+  } else if (std::strcmp(name, "phases") == 0) {
+    engine = MatchingEngine::phases;
+  } else if (std::strcmp(name, "incremental") == 0) {
+    engine = MatchingEngine::incremental;
+  } else if (std::strcmp(name, "parallel") == 0) {
+    engine = MatchingEngine::parallel;
+  } else if (std::strcmp(name, "hopcroft-karp") == 0) {
+    engine = MatchingEngine::hopcroft_karp;
+  } else {
+    return false;
+  }
+  return true;
+}
 
-  return *current_matching;
-}
\ No newline at end of file
+char const *engine_name(MatchingEngine const engine) {
+  switch (engine) {
+  case MatchingEngine::edmonds:
+    return "edmonds";
+  case MatchingEngine::phases:
+    return "phases";
+  case MatchingEngine::incremental:
+    return "incremental";
+  case MatchingEngine::parallel:
+    return "parallel";
+  case MatchingEngine::hopcroft_karp:
+    return "hopcroft-karp";
+  case MatchingEngine::none:
+    return "none";
+  }
+  return "unknown";
+}
@@ -1,10 +1,119 @@
 #ifndef MAXIMUM_CARDINALITY_MATCHING_H
 #define MAXIMUM_CARDINALITY_MATCHING_H
 
+#include <cstddef>
+#include <cstdint>
+
+#include "csr_graph.hpp"
 #include "graph.hpp"
+#include "initial_matching.hpp"
+#include "matching.hpp"
 
+using ED::CsrGraph;
 using ED::Graph;
+using ED::Matching;
+using ED::MatchingInitializer;
+
+//! Algorithms for growing the initial matching to a maximum one.
+enum class MatchingEngine {
+  //! Grows one alternating tree at a time and removes frustrated trees
+  edmonds,
+  //! Grows a forest rooted at all exposed nodes per phase and augments along
+  //! vertex-disjoint, not necessarily shortest, paths (see phase_matching.hpp)
+  phases,
+  //! Grows one forest rooted at all exposed nodes and keeps it across
+  //! augmentations, dissolving only the trees on each augmenting path
+  incremental,
+  //! Concurrent searches from many exposed nodes on all threads (see
+  //! parallel_matching.hpp), then @c edmonds for the remaining exposed nodes
+  parallel,
+  //! Hopcroft-Karp for bipartite graphs only (see bipartite_matching.hpp)
+  hopcroft_karp,
+  //! Only reported: no engine ran since no edges were left, e.g. because the
+  //! kernel is empty
+  none
+};
+
+struct MatchingOptions {
+  MatchingEngine engine = MatchingEngine::edmonds;
+  MatchingInitializer initializer = MatchingInitializer::greedy;
+  //! Seed for randomized initializers
+  std::uint64_t seed = 0;
+  //! Number of threads for parallel initializers and engines
+  unsigned num_threads = 1;
+  //! Test whether the graph is bipartite first and use @c hopcroft_karp
+  //! instead of @c engine if it is
+  bool detect_bipartite = true;
+  //! Solve the connected components separately and concurrently
+  bool split_components = true;
+  //! Shrink the graph by exact reductions first (see kernel.hpp)
+  bool reduce_graph = true;
+};
+
+/**
+   @brief Parses the name of an engine as used on the command line (e.g.
+"hopcroft-karp"). @return Whether @c name is a known engine.
+**/
+bool parse_engine(char const *name, MatchingEngine &engine);
+
+/** @return The name of @c engine as used on the command line. **/
+char const *engine_name(MatchingEngine const engine);
+
+//! Numbers collected while computing a matching.
+struct MatchingReport {
+  //! The engine that computed the matching (of the largest component)
+  MatchingEngine engine = MatchingEngine::edmonds;
+  //! Number of components with edges that were solved separately (1 if the
+  //! graph was solved as a whole)
+  std::size_t num_components = 0;
+  //! Size of the graph left after the reductions; the other numbers refer to
+  //! this graph
+  std::size_t kernel_num_nodes = 0;
+  std::size_t kernel_num_edges = 0;
+  //! Number of edges of the matching found by the initializer
+  std::size_t initial_matching_size = 0;
+  //! Number of nodes looked at while searching for roots of alternating trees
+  //! (Edmonds engine only)
+  std::size_t root_nodes_scanned = 0;
+  //! Number of augmentations after the initial matching
+  std::size_t num_augmentations = 0;
+  //! Number of nodes scanned again after augmentations (incremental engine
+  //! only)
+  std::size_t rescanned_nodes = 0;
+
+  //! Wall times in seconds of the reductions and the initial matching
+  double reduction_seconds = 0;
+  double initial_matching_seconds = 0;
+  //! Statistics of the Edmonds engine, only collected if ED_STATS is enabled
+  //! (see stats.hpp). Times are summed over the components, the growth time
+  //! does not include shrinking and augmenting.
+  double tree_growth_seconds = 0;
+  double blossom_shrink_seconds = 0;
+  double augment_seconds = 0;
+  std::size_t frustrated_trees = 0;
+  std::size_t blossoms_shrunk = 0;
+  std::size_t max_blossom_depth = 0;
+  std::size_t edges_scanned = 0;
+};
+
+/**
+   @brief Computes a maximum cardinality matching of @c graph.
+
+   Unless disabled in @c options, the graph is first shrunk to its kernel (see
+kernel.hpp), whose maximum matching is lifted back to the graph at the end.
+The kernel is split into its connected components (see components.hpp), which
+are solved on @c options.num_threads threads, largest first, and the results
+are mapped back to the original node ids. Components are claimed dynamically,
+so a thread that finishes a small component takes the next one.
 
-Graph compute_maximum_cardinality_matching(const Graph &graph);
+   If @c report is not null, it is filled with details about the computation.
+Throws if @c hopcroft_karp is requested for a graph that is not bipartite.
+**/
+Matching compute_maximum_cardinality_matching(
+    const Graph &graph, const MatchingOptions &options = MatchingOptions(),
+    MatchingReport *report = nullptr);
+Matching compute_maximum_cardinality_matching(
+    const CsrGraph &graph, const MatchingOptions &options = MatchingOptions(),
+    MatchingReport *report = nullptr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,9 @@
+#include "parallel.hpp" // always include corresponding header first
+
+namespace ED {
+
+unsigned default_num_threads() {
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+} // namespace ED
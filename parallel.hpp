@@ -0,0 +1,115 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+/**
+   @file parallel.hpp
+
+   @brief Minimal helpers to run independent tasks on several threads.
+**/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ED {
+
+/** @return The number of hardware threads (at least 1). **/
+unsigned default_num_threads();
+
+/**
+   @brief Calls <tt>function(worker_idx, task_idx)</tt> for every task index in
+<tt>[0, num_tasks)</tt> using up to @c num_threads threads. Tasks are claimed
+dynamically from a shared counter. @c worker_idx is in <tt>[0,
+num_threads)</tt> and identifies the calling thread, so it can be used to
+index per-thread data.
+
+   If tasks throw, the exception of the task with the smallest index is
+rethrown after all threads have finished, so errors are reported
+deterministically.
+**/
+template <typename Function>
+void parallel_for_workers(std::size_t const num_tasks,
+                          unsigned const num_threads,
+                          Function const &function) {
+  std::size_t const num_workers =
+      std::min<std::size_t>(std::max(num_threads, 1u), num_tasks);
+  if (num_workers <= 1) {
+    for (std::size_t task_idx = 0; task_idx < num_tasks; ++task_idx) {
+      function(std::size_t(0), task_idx);
+    }
+    return;
+  }
+
+  std::atomic<std::size_t> next_task(0);
+  std::mutex error_mutex;
+  std::size_t error_task = num_tasks;
+  std::exception_ptr error;
+
+  auto worker = [&](std::size_t const worker_idx) {
+    for (std::size_t task_idx = next_task++; task_idx < num_tasks;
+         task_idx = next_task++) {
+      try {
+        function(worker_idx, task_idx);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (task_idx < error_task) {
+          error_task = task_idx;
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_workers - 1);
+  for (std::size_t thread_idx = 1; thread_idx < num_workers; ++thread_idx) {
+    threads.emplace_back(worker, thread_idx);
+  }
+  worker(0);
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/**
+   @brief Calls <tt>function(task_idx)</tt> for every task index in <tt>[0,
+num_tasks)</tt> using up to @c num_threads threads, see @c
+parallel_for_workers.
+**/
+template <typename Function>
+void parallel_for(std::size_t const num_tasks, unsigned const num_threads,
+                  Function const &function) {
+  parallel_for_workers(num_tasks, num_threads,
+                       [&](std::size_t, std::size_t const task_idx) {
+                         function(task_idx);
+                       });
+}
+
+/**
+   @brief Splits <tt>[0, size)</tt> into blocks of roughly equal size, one
+task per block, and calls <tt>function(begin, end)</tt> for each block in
+parallel.
+**/
+template <typename Function>
+void parallel_for_blocks(std::size_t const size, unsigned const num_threads,
+                         Function const &function) {
+  std::size_t constexpr min_block_size = 1 << 14;
+  std::size_t const num_blocks = std::max<std::size_t>(
+      1, std::min<std::size_t>(4 * std::max(num_threads, 1u),
+                               size / min_block_size));
+  parallel_for(num_blocks, num_threads, [&](std::size_t const block_idx) {
+    function(size * block_idx / num_blocks, size * (block_idx + 1) / num_blocks);
+  });
+}
+
+} // namespace ED
+
+#endif /* PARALLEL_HPP */
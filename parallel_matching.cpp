@@ -0,0 +1,273 @@
+#include "parallel_matching.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "blossom_union_find.hpp"
+#include "parallel.hpp"
+
+namespace ED {
+
+namespace {
+
+enum Label : std::uint8_t { ODD, EVEN };
+
+// Node data shared by the searches of all threads. The searches of one round
+// have different tokens, and the entries of a node are only accessed by the
+// search whose token it holds in owners, so the arrays need no locking and are
+// allocated once instead of once per thread.
+struct SharedForest {
+  explicit SharedForest(NodeId const num_nodes)
+      : owners(num_nodes), blossoms(num_nodes), label(num_nodes),
+        parent(num_nodes), lca_mark(num_nodes, 0) {}
+
+  // Token of the search that claimed a node, 0 for never
+  std::vector<std::atomic<std::uint32_t>> owners;
+  // Only reset node by node, never for the whole forest
+  BlossomUnionFind blossoms;
+  std::vector<std::uint8_t> label;
+  std::vector<NodeId> parent;
+  std::vector<std::uint8_t> lca_mark;
+};
+
+// Workspace of one thread for single-root searches. Node data lives in the
+// shared forest, so the workspace itself only grows with the trees it builds.
+class TreeSearch {
+public:
+  TreeSearch(CsrGraph const &graph, Matching const &matching,
+             SharedForest &forest)
+      : _graph(graph), _matching(matching), _forest(forest) {}
+
+  // Grows an alternating tree from root, claiming its nodes with token, which
+  // is unique among the searches of the round; tokens below first_token belong
+  // to earlier rounds. On success, path holds an augmenting path (ending in
+  // root) and true is returned.
+  bool run(NodeId root, std::uint32_t token, std::uint32_t first_token,
+           std::vector<NodeId> &path);
+
+  // Adjacency entries looked at by all runs so far
+  std::size_t edges_scanned() const { return _edges_scanned; }
+
+private:
+  bool claim(NodeId const node_id) {
+    std::atomic<std::uint32_t> &owner = _forest.owners[node_id];
+    std::uint32_t token = owner.load(std::memory_order_relaxed);
+    while (token < _first_token) {
+      if (owner.compare_exchange_weak(token, _token,
+                                      std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  bool in_tree(NodeId const node_id) const {
+    return _forest.owners[node_id].load(std::memory_order_relaxed) == _token;
+  }
+  NodeId base(NodeId const node_id) const {
+    return _forest.blossoms.base(node_id);
+  }
+  // Requires that node_id has been claimed
+  void add_to_tree(NodeId const node_id, Label const label,
+                   NodeId const parent_id) {
+    _forest.blossoms.reset(node_id);
+    _forest.label[node_id] = label;
+    _forest.parent[node_id] = parent_id;
+    if (label == EVEN) {
+      _queue.push_back(node_id);
+    }
+  }
+
+  NodeId find_lca(NodeId a, NodeId b);
+  void shrink_path(NodeId node_id, NodeId lca, NodeId child);
+
+  CsrGraph const &_graph;
+  Matching const &_matching;
+  SharedForest &_forest;
+  std::uint32_t _token = 0;
+  std::uint32_t _first_token = 0;
+  std::size_t _edges_scanned = 0;
+  std::vector<NodeId> _queue;
+  std::vector<NodeId> _shrunk;
+  std::vector<NodeId> _lca_marked;
+};
+
+// Same as in phase_matching.cpp: alternate between both paths to the root
+NodeId TreeSearch::find_lca(NodeId a, NodeId b) {
+  std::vector<std::uint8_t> &lca_mark = _forest.lca_mark;
+  a = base(a);
+  b = base(b);
+  NodeId lca = invalid_node_id;
+  while (true) {
+    if (a != invalid_node_id) {
+      if (lca_mark[a]) {
+        lca = a;
+        break;
+      }
+      lca_mark[a] = 1;
+      _lca_marked.push_back(a);
+      a = _matching.is_exposed(a) ? invalid_node_id
+                                  : base(_forest.parent[_matching.mate(a)]);
+    }
+    std::swap(a, b);
+  }
+  for (NodeId const node_id : _lca_marked) {
+    lca_mark[node_id] = 0;
+  }
+  _lca_marked.clear();
+  return lca;
+}
+
+void TreeSearch::shrink_path(NodeId node_id, NodeId const lca, NodeId child) {
+  while (base(node_id) != lca) {
+    NodeId const mate_id = _matching.mate(node_id);
+    _shrunk.push_back(node_id);
+    _shrunk.push_back(mate_id);
+    if (_forest.label[mate_id] == ODD) {
+      _forest.label[mate_id] = EVEN;
+      _queue.push_back(mate_id);
+    }
+    _forest.parent[node_id] = child;
+    child = mate_id;
+    node_id = _forest.parent[mate_id];
+  }
+}
+
+bool TreeSearch::run(NodeId const root, std::uint32_t const token,
+                     std::uint32_t const first_token,
+                     std::vector<NodeId> &path) {
+  _token = token;
+  _first_token = first_token;
+  if (not claim(root)) {
+    return false;
+  }
+  _queue.clear();
+  add_to_tree(root, EVEN, invalid_node_id);
+
+  BlossomUnionFind &blossoms = _forest.blossoms;
+  for (std::size_t queue_idx = 0; queue_idx < _queue.size(); ++queue_idx) {
+    NodeId const node_id = _queue[queue_idx];
+    _edges_scanned += _graph.node(node_id).degree();
+    for (NodeId const neighbor_id : _graph.node(node_id).neighbors()) {
+      if (in_tree(neighbor_id)) {
+        if (_forest.label[neighbor_id] == EVEN and
+            base(node_id) != base(neighbor_id)) {
+          NodeId const lca = find_lca(node_id, neighbor_id);
+          shrink_path(node_id, lca, neighbor_id);
+          shrink_path(neighbor_id, lca, node_id);
+          for (NodeId const shrunk_id : _shrunk) {
+            blossoms.unite(lca, shrunk_id);
+          }
+          blossoms.set_blossom(lca, lca, 0);
+          _shrunk.clear();
+        }
+        continue;
+      }
+      if (not claim(neighbor_id)) {
+        continue; // belongs to another search of this round
+      }
+      if (_matching.is_exposed(neighbor_id)) {
+        path.clear();
+        path.push_back(neighbor_id);
+        path.push_back(node_id);
+        for (NodeId even_id = node_id; not _matching.is_exposed(even_id);) {
+          NodeId const odd_id = _matching.mate(even_id);
+          even_id = _forest.parent[odd_id];
+          path.push_back(odd_id);
+          path.push_back(even_id);
+        }
+        return true;
+      }
+      // If the mate belongs to another search, neighbor_id stays an odd leaf
+      // of no use to anybody
+      add_to_tree(neighbor_id, ODD, node_id);
+      NodeId const mate_id = _matching.mate(neighbor_id);
+      if (claim(mate_id)) {
+        add_to_tree(mate_id, EVEN, invalid_node_id);
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+std::size_t augment_in_parallel(CsrGraph const &graph, Matching &matching,
+                                unsigned const num_threads) {
+  SharedForest forest(graph.num_nodes());
+  std::vector<TreeSearch> searches;
+  searches.reserve(std::max(num_threads, 1u));
+  for (unsigned thread_idx = 0; thread_idx < std::max(num_threads, 1u);
+       ++thread_idx) {
+    searches.emplace_back(graph, matching, forest);
+  }
+
+  // Exposed nodes only get matched, so the roots are collected once and the
+  // list shrinks with every round
+  std::vector<NodeId> roots;
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (matching.is_exposed(node_id) and graph.node(node_id).degree() > 0) {
+      roots.push_back(node_id);
+    }
+  }
+
+  // Every round searches from all remaining roots again, but fewer searches
+  // succeed once the short augmenting paths are gone. Rounds stop as soon as
+  // one spends more than max_work_per_path adjacency entries per thread and
+  // augmented path, which bounds the work of all rounds but the last by
+  // O(num_threads * n); the caller finishes with a sequential search.
+  std::size_t const max_work_per_path =
+      32 * std::size_t{std::max(num_threads, 1u)};
+  std::size_t work = 0;
+  std::uint32_t round = 0;
+  std::uint32_t next_token = 1;
+  std::vector<std::vector<NodeId>> paths;
+  while (not roots.empty()) {
+    ++round;
+    if (next_token > std::numeric_limits<std::uint32_t>::max() - roots.size()) {
+      for (std::atomic<std::uint32_t> &owner : forest.owners) {
+        owner.store(0, std::memory_order_relaxed);
+      }
+      next_token = 1;
+    }
+    std::uint32_t const first_token = next_token;
+    next_token += static_cast<std::uint32_t>(roots.size());
+    paths.assign(roots.size(), std::vector<NodeId>());
+    parallel_for_workers(
+        roots.size(), num_threads,
+        [&](std::size_t const worker_idx, std::size_t const root_idx) {
+          searches[worker_idx].run(
+              roots[root_idx],
+              first_token + static_cast<std::uint32_t>(root_idx), first_token,
+              paths[root_idx]);
+        });
+
+    std::size_t num_augmented = 0;
+    for (std::vector<NodeId> const &path : paths) {
+      if (not path.empty()) {
+        matching.augment(path);
+        ++num_augmented;
+      }
+    }
+    std::size_t const previous_work = work;
+    work = 0;
+    for (TreeSearch const &search : searches) {
+      work += search.edges_scanned();
+    }
+    if (num_augmented == 0 or
+        work - previous_work > max_work_per_path * num_augmented) {
+      break;
+    }
+    roots.erase(std::remove_if(roots.begin(), roots.end(),
+                               [&](NodeId const node_id) {
+                                 return not matching.is_exposed(node_id);
+                               }),
+                roots.end());
+  }
+  return round;
+}
+
+} // namespace ED
@@ -0,0 +1,44 @@
+#ifndef PARALLEL_MATCHING_HPP
+#define PARALLEL_MATCHING_HPP
+
+/**
+   @file parallel_matching.hpp
+
+   @brief Augmenting path searches from many exposed nodes at once on several
+threads.
+**/
+
+#include <cstddef>
+
+#include "csr_graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+/**
+   @brief Augments @c matching in rounds of concurrent searches.
+
+   In every round, each exposed node is the root of an alternating tree search
+(with blossom shrinking) run by one of @c num_threads threads. A search claims
+every node it adds to its tree with an atomic compare-and-swap and treats nodes
+claimed by other searches as absent, so the trees of one round are
+vertex-disjoint and all augmenting paths found in a round can be applied. The
+matching is only read during a round; the paths are applied sequentially
+afterwards.
+
+   Exposed nodes are collected once; each round searches from those still
+exposed. Since searches block each other, the result is in general not
+maximum, and later rounds repeat most of their work for few paths. Rounds stop
+once one scans more than <tt>32 * num_threads</tt> adjacency entries per
+augmented path, so all rounds but the last take O(num_threads * n) work in
+total. The remaining exposed nodes are meant to be handled by a sequential
+search; on a single thread, the rounds are slower than that search alone.
+
+   @return The number of rounds.
+**/
+std::size_t augment_in_parallel(CsrGraph const &graph, Matching &matching,
+                                unsigned const num_threads);
+
+} // namespace ED
+
+#endif /* PARALLEL_MATCHING_HPP */
@@ -0,0 +1,276 @@
+#include "phase_matching.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "blossom_union_find.hpp"
+
+namespace ED {
+
+namespace {
+
+enum Label : std::uint8_t { UNLABELED, EVEN, ODD };
+
+// The alternating forest of one phase. Every node in a tree has a label; odd
+// nodes store the even node they were reached from in _parent. When a blossom
+// is shrunk, its even nodes get _parent pointing across the blossom, so that
+// following "mate, then parent" from any even node leads back to the root
+// along an alternating path. The nodes of each tree are linked in a list
+// starting at _tree_head[root], so that a single tree can be dissolved.
+class AlternatingForest {
+public:
+  AlternatingForest(CsrGraph const &graph, Matching &matching)
+      : _graph(graph), _matching(matching), _blossoms(graph.num_nodes()),
+        _label(graph.num_nodes()), _parent(graph.num_nodes()),
+        _root(graph.num_nodes()), _frozen(graph.num_nodes()),
+        _next_in_tree(graph.num_nodes()), _tree_head(graph.num_nodes()),
+        _pending(graph.num_nodes(), false), _lca_mark(graph.num_nodes(), 0) {}
+
+  // Grows a forest from all exposed nodes and returns the number of
+  // augmentations. After an augmentation, its two trees are frozen until the
+  // end of the call, or dissolved at once if incremental is set.
+  std::size_t run(bool incremental);
+
+  // Number of even nodes scanned again because a neighboring tree was
+  // dissolved
+  std::size_t num_rescanned() const { return _num_rescanned; }
+
+  // Whether the node is an odd node of the forest (not in a blossom)
+  bool is_odd(NodeId const node_id) const { return _label[node_id] == ODD; }
+
+private:
+  NodeId base(NodeId const node_id) const { return _blossoms.base(node_id); }
+  bool is_frozen(NodeId const node_id) const {
+    return _frozen[_root[node_id]];
+  }
+
+  void enqueue(NodeId const node_id) {
+    if (not _pending[node_id]) {
+      _pending[node_id] = true;
+      _queue.push_back(node_id);
+    }
+  }
+  void add_to_tree(NodeId const node_id, Label const label,
+                   NodeId const root_id) {
+    _label[node_id] = label;
+    _root[node_id] = root_id;
+    _next_in_tree[node_id] = _tree_head[root_id];
+    _tree_head[root_id] = node_id;
+    if (label == EVEN) {
+      enqueue(node_id);
+    }
+  }
+
+  NodeId find_lca(NodeId a, NodeId b);
+  void shrink_path(NodeId node_id, NodeId lca, NodeId child);
+  void flip_path_to_root(NodeId node_id);
+  void dissolve_trees(NodeId root_id, NodeId other_root_id);
+
+  CsrGraph const &_graph;
+  Matching &_matching;
+  BlossomUnionFind _blossoms;
+  std::vector<std::uint8_t> _label;
+  std::vector<NodeId> _parent;
+  std::vector<NodeId> _root;
+  std::vector<char> _frozen;          // indexed by root
+  std::vector<NodeId> _next_in_tree;
+  std::vector<NodeId> _tree_head;     // indexed by root
+  std::vector<char> _pending;         // whether the node is in _queue
+  std::size_t _num_rescanned = 0;
+  std::vector<std::uint32_t> _lca_mark;
+  std::uint32_t _lca_epoch = 0;
+  std::vector<NodeId> _queue;
+  std::vector<NodeId> _shrunk;
+};
+
+// Walks up from both nodes alternately; the first node visited twice is the
+// base of the lowest common ancestor. Costs O(size of the new blossom).
+NodeId AlternatingForest::find_lca(NodeId a, NodeId b) {
+  if (++_lca_epoch == 0) {
+    std::fill(_lca_mark.begin(), _lca_mark.end(), 0);
+    _lca_epoch = 1;
+  }
+  a = base(a);
+  b = base(b);
+  while (true) {
+    if (a != invalid_node_id) {
+      if (_lca_mark[a] == _lca_epoch) {
+        return a;
+      }
+      _lca_mark[a] = _lca_epoch;
+      a = _matching.is_exposed(a) ? invalid_node_id
+                                  : base(_parent[_matching.mate(a)]);
+    }
+    std::swap(a, b);
+  }
+}
+
+// Walks the tree path from node_id up to the blossom with base lca, redirects
+// the parents across the new blossom and collects the blossoms on the path in
+// _shrunk. child is the node on the other side of the blossom-closing edge.
+// The blossoms are only united afterwards, since the walk relies on the old
+// bases.
+void AlternatingForest::shrink_path(NodeId node_id, NodeId const lca,
+                                    NodeId child) {
+  while (base(node_id) != lca) {
+    NodeId const mate_id = _matching.mate(node_id);
+    _shrunk.push_back(node_id);
+    _shrunk.push_back(mate_id);
+    if (_label[mate_id] == ODD) {
+      // Odd nodes become even inside the blossom and have to be scanned
+      _label[mate_id] = EVEN;
+      enqueue(mate_id);
+    }
+    _parent[node_id] = child;
+    child = mate_id;
+    node_id = _parent[mate_id];
+  }
+}
+
+// Rematches the tree path from the even node node_id to its root such that
+// node_id becomes exposed and the root becomes matched
+void AlternatingForest::flip_path_to_root(NodeId const node_id) {
+  NodeId odd_id = _matching.mate(node_id);
+  while (odd_id != invalid_node_id) {
+    NodeId const even_id = _parent[odd_id];
+    NodeId const next_odd_id = _matching.mate(even_id);
+    _matching.match(odd_id, even_id);
+    odd_id = next_odd_id;
+  }
+}
+
+// Removes the nodes of both trees from the forest. Edges from the remaining
+// trees to these nodes may now extend those trees, so the even nodes adjacent
+// to them are scanned again.
+void AlternatingForest::dissolve_trees(NodeId const root_id,
+                                       NodeId const other_root_id) {
+  for (NodeId const tree_root : {root_id, other_root_id}) {
+    for (NodeId node_id = _tree_head[tree_root]; node_id != invalid_node_id;
+         node_id = _next_in_tree[node_id]) {
+      _label[node_id] = UNLABELED;
+      _blossoms.reset(node_id);
+    }
+  }
+  for (NodeId const tree_root : {root_id, other_root_id}) {
+    for (NodeId node_id = _tree_head[tree_root]; node_id != invalid_node_id;
+         node_id = _next_in_tree[node_id]) {
+      for (NodeId const neighbor_id : _graph.node(node_id).neighbors()) {
+        if (_label[neighbor_id] == EVEN and not _pending[neighbor_id]) {
+          enqueue(neighbor_id);
+          ++_num_rescanned;
+        }
+      }
+    }
+    _tree_head[tree_root] = invalid_node_id;
+  }
+}
+
+std::size_t AlternatingForest::run(bool const incremental) {
+  std::fill(_label.begin(), _label.end(), UNLABELED);
+  std::fill(_frozen.begin(), _frozen.end(), false);
+  std::fill(_pending.begin(), _pending.end(), false);
+  _blossoms.begin_tree();
+  _queue.clear();
+
+  for (NodeId node_id = 0; node_id < _graph.num_nodes(); ++node_id) {
+    if (_matching.is_exposed(node_id) and _graph.node(node_id).degree() > 0) {
+      _tree_head[node_id] = invalid_node_id;
+      _parent[node_id] = invalid_node_id;
+      add_to_tree(node_id, EVEN, node_id);
+    }
+  }
+
+  std::size_t augmentations = 0;
+  for (std::size_t queue_idx = 0; queue_idx < _queue.size(); ++queue_idx) {
+    NodeId const node_id = _queue[queue_idx];
+    _pending[node_id] = false;
+    for (NodeId const neighbor_id : _graph.node(node_id).neighbors()) {
+      // The tree of node_id may have been frozen or dissolved meanwhile
+      if (_label[node_id] != EVEN or is_frozen(node_id)) {
+        break;
+      }
+      if (base(node_id) == base(neighbor_id) or
+          _matching.mate(node_id) == neighbor_id) {
+        continue;
+      }
+      if (_label[neighbor_id] == UNLABELED) {
+        // All exposed nodes are roots, so neighbor_id is matched: grow the tree
+        NodeId const mate_id = _matching.mate(neighbor_id);
+        assert(mate_id != invalid_node_id);
+        _parent[neighbor_id] = node_id;
+        add_to_tree(neighbor_id, ODD, _root[node_id]);
+        add_to_tree(mate_id, EVEN, _root[node_id]);
+      } else if (_label[neighbor_id] == EVEN and not is_frozen(neighbor_id)) {
+        if (_root[neighbor_id] != _root[node_id]) {
+          // Augmenting path: root ... node_id - neighbor_id ... other root
+          NodeId const root_id = _root[node_id];
+          NodeId const other_root_id = _root[neighbor_id];
+          flip_path_to_root(node_id);
+          flip_path_to_root(neighbor_id);
+          _matching.match(node_id, neighbor_id);
+          if (incremental) {
+            dissolve_trees(root_id, other_root_id);
+          } else {
+            _frozen[root_id] = true;
+            _frozen[other_root_id] = true;
+          }
+          ++augmentations;
+        } else {
+          // Odd cycle within one tree: shrink it
+          NodeId const lca = find_lca(node_id, neighbor_id);
+          shrink_path(node_id, lca, neighbor_id);
+          shrink_path(neighbor_id, lca, node_id);
+          for (NodeId const shrunk_id : _shrunk) {
+            _blossoms.unite(lca, shrunk_id);
+          }
+          _blossoms.set_blossom(lca, lca, 0);
+          _shrunk.clear();
+        }
+      }
+    }
+  }
+  return augmentations;
+}
+
+} // namespace
+
+std::size_t augment_by_phases(CsrGraph const &graph, Matching &matching) {
+  AlternatingForest forest(graph, matching);
+  std::size_t num_phases = 1;
+  while (forest.run(false) > 0) {
+    ++num_phases;
+  }
+  return num_phases;
+}
+
+IncrementalSearchStats augment_incrementally(CsrGraph const &graph,
+                                             Matching &matching) {
+  AlternatingForest forest(graph, matching);
+  IncrementalSearchStats stats;
+  stats.num_augmentations = forest.run(true);
+  stats.num_rescanned = forest.num_rescanned();
+  return stats;
+}
+
+std::vector<NodeId> find_tutte_berge_barrier(CsrGraph const &graph,
+                                             Matching const &matching) {
+  Matching copy = matching;
+  AlternatingForest forest(graph, copy);
+  if (forest.run(false) > 0) {
+    throw std::runtime_error("The matching is not maximum.");
+  }
+  std::vector<NodeId> barrier;
+  for (NodeId node_id = 0; node_id < graph.num_nodes(); ++node_id) {
+    if (forest.is_odd(node_id)) {
+      barrier.push_back(node_id);
+    }
+  }
+  return barrier;
+}
+
+} // namespace ED
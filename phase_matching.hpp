@@ -0,0 +1,79 @@
+#ifndef PHASE_MATCHING_HPP
+#define PHASE_MATCHING_HPP
+
+/**
+   @file phase_matching.hpp
+
+   @brief Phase-based augmentation: every phase grows an alternating forest
+from all exposed nodes at once (in breadth-first order) and augments along
+vertex-disjoint augmenting paths until the forest cannot grow any more.
+**/
+
+#include <cstddef>
+#include <vector>
+
+#include "csr_graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+/**
+   @brief Augments @c matching to a maximum matching of @c graph.
+
+   In each phase, all exposed nodes are roots of alternating trees that are
+grown simultaneously in breadth-first order. Blossoms are shrunk with a
+@c BlossomUnionFind. An edge between even nodes of two different trees yields an
+augmenting path; after augmenting, both trees are frozen for the rest of the
+phase while the other trees keep growing, so one phase augments along a maximal
+collection of vertex-disjoint paths found by the search. A phase that finds no
+augmenting path has built a Hungarian forest, which proves the matching is
+maximum.
+
+   Unlike Micali-Vazirani, the paths of a phase are not restricted to the
+shortest augmenting path length: breadth-first order only tends to find short
+paths, and a bridge between two trees is used as soon as it is scanned. Hence
+the O(sqrt(n) m) bound does not apply; there may be O(n) phases, each of which
+costs O(m alpha(n)).
+
+   @return The number of phases.
+**/
+std::size_t augment_by_phases(CsrGraph const &graph, Matching &matching);
+
+struct IncrementalSearchStats {
+  std::size_t num_augmentations = 0;
+  //! Even nodes whose neighbors were scanned again after an augmentation
+  std::size_t num_rescanned = 0;
+};
+
+/**
+   @brief Augments @c matching to a maximum matching of @c graph with a single
+alternating forest that is kept across augmentations.
+
+   Like a phase of @c augment_by_phases, but an augmentation only dissolves the
+two trees it connects; all other trees, their blossoms and their scanned
+edges stay valid. Of the remaining even nodes, only those adjacent to a
+dissolved node are scanned again. Once no node is left to scan, the forest is
+a Hungarian forest.
+**/
+IncrementalSearchStats augment_incrementally(CsrGraph const &graph,
+                                             Matching &matching);
+
+/**
+   @brief Computes a Tutte-Berge barrier that proves @c matching maximum.
+
+   Grows one alternating forest from all exposed nodes like a phase of
+@c augment_by_phases. Since there is no augmenting path, it is a Hungarian
+forest, and the returned set A of its odd nodes (in increasing order) is a
+Gallai-Edmonds barrier: every outer blossom is an odd component of the graph
+without A, so G - A has at least |A| + (number of exposed nodes) odd
+components, and by the Tutte-Berge formula no matching is larger. Takes
+O(m alpha(n)) time; see certificate.hpp for checking the barrier.
+
+   Throws if @c matching is not maximum.
+**/
+std::vector<NodeId> find_tutte_berge_barrier(CsrGraph const &graph,
+                                             Matching const &matching);
+
+} // namespace ED
+
+#endif /* PHASE_MATCHING_HPP */
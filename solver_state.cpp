@@ -0,0 +1,52 @@
+#include "solver_state.hpp" // always include corresponding header first
+
+namespace ED {
+
+SolverState::SolverState(NodeId const num_nodes)
+    : _node_dists(num_nodes), _predecessors(num_nodes), _blossoms(num_nodes),
+      _first_cycle(num_nodes), _covered(num_nodes, 0),
+      _removed(num_nodes, false) {}
+
+void SolverState::begin_tree() {
+  if (++_tree_epoch == 0) {
+    // The epoch counter wrapped, so old stamps could be mistaken for new ones
+    _node_dists.reset();
+    _predecessors.reset();
+    _first_cycle.reset();
+    _tree_epoch = 1;
+  }
+  _blossoms.begin_tree();
+  _larger_cycle.clear();
+}
+
+void SolverState::clear_covered() {
+  if (++_covered_epoch == 0) {
+    std::fill(_covered.begin(), _covered.end(), 0);
+    _covered_epoch = 1;
+  }
+  _covered_list.clear();
+}
+
+void SolverState::set_larger_cycle(size_t const cycle_idx, size_t const larger,
+                                   size_t const position) {
+  if (_larger_cycle.size() <= cycle_idx) {
+    _larger_cycle.resize(cycle_idx + 1, CycleSlot{no_cycle, 0});
+  }
+  _larger_cycle[cycle_idx] = CycleSlot{larger, position};
+}
+
+void SolverState::cover(NodeId const id) {
+  if (_covered[id] != _covered_epoch) {
+    _covered[id] = _covered_epoch;
+    _covered_list.push_back(id);
+  }
+}
+
+void SolverState::remove(NodeId const id) {
+  if (not _removed[id]) {
+    _removed[id] = true;
+    ++_num_removed;
+  }
+}
+
+} // namespace ED
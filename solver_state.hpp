@@ -0,0 +1,167 @@
+#ifndef SOLVER_STATE_HPP
+#define SOLVER_STATE_HPP
+
+/**
+   @file solver_state.hpp
+
+   @brief Dense per-node bookkeeping used while growing alternating trees.
+
+   Node ids are dense (0, ..., n-1), so every per-node attribute of the search
+is kept in a flat array indexed by @c NodeId. Attributes that are only valid
+for the current alternating tree are stamped with an epoch: starting a new tree
+just increments the epoch instead of clearing O(n) memory.
+**/
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "blossom_union_find.hpp"
+#include "graph.hpp"
+
+namespace ED {
+
+using Epoch = std::uint32_t;
+
+/**
+   @class StampedArray
+
+   @brief An array of @c T indexed by @c NodeId whose entries are only
+considered set if they were written during the current epoch.
+**/
+template <typename T> class StampedArray {
+public:
+  explicit StampedArray(NodeId const num_nodes)
+      : _values(num_nodes), _stamps(num_nodes, 0) {}
+
+  /** @return Whether the entry of @c id was set during epoch @c epoch. **/
+  bool contains(NodeId const id, Epoch const epoch) const {
+    return _stamps[id] == epoch;
+  }
+
+  /** @warning Only meaningful if @c contains(id, epoch) holds. **/
+  T const &get(NodeId const id) const { return _values[id]; }
+  T &get(NodeId const id) { return _values[id]; }
+
+  void set(NodeId const id, T value, Epoch const epoch) {
+    _values[id] = std::move(value);
+    _stamps[id] = epoch;
+  }
+
+  /** @brief Forgets all entries, needed once the epoch counter wraps. **/
+  void reset() { std::fill(_stamps.begin(), _stamps.end(), 0); }
+
+private:
+  std::vector<T> _values;
+  std::vector<Epoch> _stamps;
+};
+
+/**
+   @class SolverState
+
+   @brief Replaces the hash maps and hash sets previously used by the tree
+growing code with dense arrays.
+
+   Tree-local data (distances, predecessors, blossoms, first cycles) is
+invalidated by @c begin_tree(), the set of covered nodes by @c clear_covered().
+Removed nodes stay removed for the whole run.
+**/
+class SolverState {
+public:
+  explicit SolverState(NodeId const num_nodes);
+
+  /** @brief Invalidates all tree-local data in O(1) (amortized). **/
+  void begin_tree();
+
+  /** @brief Uncovers all nodes in O(1) (amortized). **/
+  void clear_covered();
+
+  bool has_dist(NodeId const id) const {
+    return _node_dists.contains(id, _tree_epoch);
+  }
+  size_t dist(NodeId const id) const { return _node_dists.get(id); }
+  void set_dist(NodeId const id, size_t const dist) {
+    _node_dists.set(id, dist, _tree_epoch);
+  }
+
+  NodeId predecessor(NodeId const id) const { return _predecessors.get(id); }
+  void set_predecessor(NodeId const id, NodeId const predecessor) {
+    _predecessors.set(id, predecessor, _tree_epoch);
+  }
+
+  //! The blossoms (pseudonodes) shrunk in the current tree.
+  BlossomUnionFind &blossoms() { return _blossoms; }
+  BlossomUnionFind const &blossoms() const { return _blossoms; }
+
+  //! The cycle that contains the node itself (not a blossom containing it)
+  //! and the position of the node on that cycle.
+  bool has_first_cycle(NodeId const id) const {
+    return _first_cycle.contains(id, _tree_epoch);
+  }
+  size_t first_cycle(NodeId const id) const {
+    return _first_cycle.get(id).cycle_idx;
+  }
+  size_t first_cycle_position(NodeId const id) const {
+    return _first_cycle.get(id).position;
+  }
+  void set_first_cycle(NodeId const id, size_t const cycle_idx,
+                       size_t const position) {
+    _first_cycle.set(id, CycleSlot{cycle_idx, position}, _tree_epoch);
+  }
+
+  //! The cycle that contains the blossom created by cycle @c cycle_idx and the
+  //! position of that blossom on it. The cycles are numbered 0, 1, ... within
+  //! each tree, so this relation is a plain vector that is cleared with the
+  //! tree.
+  bool has_larger_cycle(size_t const cycle_idx) const {
+    return cycle_idx < _larger_cycle.size() and
+           _larger_cycle[cycle_idx].cycle_idx != no_cycle;
+  }
+  size_t larger_cycle(size_t const cycle_idx) const {
+    return _larger_cycle[cycle_idx].cycle_idx;
+  }
+  size_t larger_cycle_position(size_t const cycle_idx) const {
+    return _larger_cycle[cycle_idx].position;
+  }
+  void set_larger_cycle(size_t const cycle_idx, size_t const larger,
+                        size_t const position);
+
+  bool is_covered(NodeId const id) const {
+    return _covered[id] == _covered_epoch;
+  }
+  void cover(NodeId const id);
+  //! The nodes covered since the last call of @c clear_covered().
+  std::vector<NodeId> const &covered_nodes() const { return _covered_list; }
+
+  bool is_removed(NodeId const id) const { return _removed[id]; }
+  void remove(NodeId const id);
+  NodeId num_removed() const { return _num_removed; }
+
+private:
+  static constexpr size_t no_cycle = std::numeric_limits<size_t>::max();
+
+  struct CycleSlot {
+    size_t cycle_idx;
+    size_t position;
+  };
+
+  Epoch _tree_epoch = 1;
+  StampedArray<size_t> _node_dists;
+  StampedArray<NodeId> _predecessors;
+  BlossomUnionFind _blossoms;
+  StampedArray<CycleSlot> _first_cycle;
+  std::vector<CycleSlot> _larger_cycle;
+
+  Epoch _covered_epoch = 1;
+  std::vector<Epoch> _covered;
+  std::vector<NodeId> _covered_list;
+
+  std::vector<char> _removed;
+  NodeId _num_removed = 0;
+};
+
+} // namespace ED
+
+#endif /* SOLVER_STATE_HPP */
@@ -0,0 +1,16 @@
+#include "stats.hpp" // always include corresponding header first
+
+#include <sys/resource.h>
+
+namespace ED {
+
+std::size_t peak_rss_bytes() {
+  struct rusage usage;
+  if (::getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  // Linux reports kilobytes
+  return std::size_t(usage.ru_maxrss) * 1024;
+}
+
+} // namespace ED
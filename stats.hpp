@@ -0,0 +1,65 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+/**
+   @file stats.hpp
+
+   @brief Compile-time switch and helpers for the solver statistics.
+
+   The counters and timers inside the search loops are only compiled in if
+@c ED_STATS is nonzero (the default). Building with <tt>-DED_STATS=0</tt>
+removes them completely; the coarse timings of whole phases remain.
+**/
+
+#include <chrono>
+#include <cstddef>
+
+#ifndef ED_STATS
+#define ED_STATS 1
+#endif
+
+#if ED_STATS
+//! Expands to @c statement only if statistics are enabled
+#define ED_STATS_ONLY(statement) statement
+#else
+#define ED_STATS_ONLY(statement)
+#endif
+
+namespace ED {
+
+/** @brief Measures the wall time since its construction. **/
+class Stopwatch {
+public:
+  Stopwatch() : _start(std::chrono::steady_clock::now()) {}
+
+  /** @return The seconds since construction. **/
+  double seconds() const {
+    std::chrono::duration<double> const elapsed =
+        std::chrono::steady_clock::now() - _start;
+    return elapsed.count();
+  }
+
+private:
+  std::chrono::steady_clock::time_point _start;
+};
+
+/** @brief Adds the wall time of its lifetime to a total. **/
+class ScopedTimer {
+public:
+  explicit ScopedTimer(double &total_seconds) : _total(total_seconds) {}
+  ~ScopedTimer() { _total += _stopwatch.seconds(); }
+
+  ScopedTimer(ScopedTimer const &) = delete;
+  ScopedTimer &operator=(ScopedTimer const &) = delete;
+
+private:
+  double &_total;
+  Stopwatch _stopwatch;
+};
+
+/** @return The peak resident set size of the process in bytes. **/
+std::size_t peak_rss_bytes();
+
+} // namespace ED
+
+#endif /* STATS_HPP */
@@ -0,0 +1,1074 @@
+#include "weighted_matching.hpp" // always include corresponding header first
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "blossom_union_find.hpp"
+
+namespace ED {
+
+namespace {
+
+// The two ends of edge k are the endpoints 2k and 2k + 1, so p ^ 1 is the
+// other end of the edge of endpoint p and p / 2 is its edge.
+using EdgeId = std::size_t;
+using Endpoint = std::size_t;
+
+EdgeId constexpr no_edge = std::numeric_limits<EdgeId>::max();
+Endpoint constexpr no_endpoint = std::numeric_limits<Endpoint>::max();
+
+// Labels of top-level blossoms (and of their nodes, see below). BREADCRUMB is
+// or-ed into the label of even blossoms visited by scan_blossom.
+enum Label : std::uint8_t { UNLABELED = 0, EVEN = 1, ODD = 2, BREADCRUMB = 4 };
+
+// Ids 0, ..., n - 1 are nodes (trivial blossoms), ids n, ..., 2n - 1 are
+// non-trivial blossoms. A blossom stores its sub-blossoms in cyclic order
+// starting at the one containing the base, and _blossom_ends[b][i] is the
+// endpoint in _blossom_children[b][i] of the edge to the next sub-blossom.
+// The nodes of every non-trivial top-level blossom form one set of a
+// BlossomUnionFind, whose cycle index is the id of the blossom.
+//
+// Only top-level blossoms carry labels. Within an odd blossom, a node reached
+// by a tight edge from an even node outside is labeled ODD as well (with
+// _label_end set), so the blossom's sub-blossoms can be relabeled when it is
+// expanded in the middle of a stage.
+class WeightedBlossomSolver {
+public:
+  WeightedBlossomSolver(NodeId num_nodes, std::vector<Edge> const &edges,
+                        std::vector<Weight> const &weights);
+
+  // Runs stages until no augmenting path improves the weight
+  void run();
+
+  NodeId mate(NodeId const node_id) const {
+    return _mate[node_id] == no_endpoint ? invalid_node_id
+                                         : _endpoint[_mate[node_id]];
+  }
+  EdgeId matched_edge(NodeId const node_id) const {
+    return _mate[node_id] == no_endpoint ? no_edge : _mate[node_id] / 2;
+  }
+
+private:
+  // Candidate for the next dual update: the best edge of node or blossom id,
+  // or the dual of odd blossom id. The key is the slack (or dual) plus the
+  // total dual change at the rate at which it shrinks, so it stays valid
+  // while the duals move.
+  struct HeapEntry {
+    Weight key;
+    NodeId id;
+    EdgeId edge_id;
+  };
+  struct LargerKey {
+    bool operator()(HeapEntry const &a, HeapEntry const &b) const {
+      return a.key > b.key;
+    }
+  };
+
+  // Top-level blossom containing the node
+  NodeId top(NodeId const node_id) const {
+    return _blossoms.in_blossom(node_id)
+               ? static_cast<NodeId>(_blossoms.cycle_idx(node_id))
+               : node_id;
+  }
+  // Duals change lazily: while a top-level blossom keeps its label, its nodes
+  // have moved by the total dual change since its base, down if it is even
+  // and up if it is odd, and its own dual the other way round
+  Weight pending_change(NodeId const blossom) const {
+    if (not(_label[blossom] & (EVEN | ODD))) {
+      return 0;
+    }
+    Weight const change = _dual_change - _dual[blossom].base;
+    return _label[blossom] & EVEN ? -change : change;
+  }
+  Weight node_dual(NodeId const node_id) const {
+    return _dual[node_id].value + pending_change(top(node_id));
+  }
+  Weight blossom_dual(NodeId const blossom) const {
+    return _dual[blossom].value - pending_change(blossom);
+  }
+  Weight slack(EdgeId const edge_id) const {
+    return node_dual(_endpoint[2 * edge_id]) +
+           node_dual(_endpoint[2 * edge_id + 1]) - 2 * _weights[edge_id];
+  }
+  bool is_allowed(EdgeId const edge_id) const {
+    return _allowed[edge_id] == _stage;
+  }
+  void allow(EdgeId const edge_id) { _allowed[edge_id] = _stage; }
+  // Labels and best edges are set through these, so that only the ids
+  // touched in a stage have to be visited by resets, and the heaps learn
+  // about new candidates
+  void set_label(NodeId const id, std::uint8_t const label) {
+    if (_blossom_parent[id] == invalid_node_id) {
+      settle_dual(id);
+    }
+    _label[id] = label;
+    if (_labeled_stage[id] != _stage) {
+      _labeled_stage[id] = _stage;
+      _labeled.push_back(id);
+    }
+    if (label == ODD and not is_trivial(id) and
+        _blossom_parent[id] == invalid_node_id) {
+      push_entry(_odd_blossoms,
+                 HeapEntry{_dual[id].value + _dual_change, id, 0});
+    }
+  }
+  void set_best_edge(NodeId const id, EdgeId const edge_id,
+                     Weight const edge_slack) {
+    _best_edge[id] = edge_id;
+    _best_key[id] = edge_slack + (_label[id] & EVEN ? 2 : 1) * _dual_change;
+    if (_best_edge_stage[id] != _stage) {
+      _best_edge_stage[id] = _stage;
+      _with_best_edge.push_back(id);
+    }
+    // A best edge often improves many times between two dual updates, so
+    // the heaps only learn about it in the next update
+    if (not _heap_pending[id]) {
+      _heap_pending[id] = true;
+      _heap_updates.push_back(id);
+    }
+  }
+  // Slack of the best edge of an even blossom or an unlabeled node. It is
+  // read from the key unless the node lies in an odd blossom, where its dual
+  // does not stay put.
+  Weight best_slack(NodeId const id) const {
+    if (_label[id] & EVEN) {
+      return _best_key[id] - 2 * _dual_change;
+    }
+    if (_label[top(id)] == UNLABELED) {
+      return _best_key[id] - _dual_change;
+    }
+    return slack(_best_edge[id]);
+  }
+  void push_entry(std::vector<HeapEntry> &heap, HeapEntry const &entry) {
+    heap.push_back(entry);
+    std::push_heap(heap.begin(), heap.end(), LargerKey());
+  }
+  void pop_entry(std::vector<HeapEntry> &heap) {
+    std::pop_heap(heap.begin(), heap.end(), LargerKey());
+    heap.pop_back();
+  }
+  bool is_trivial(NodeId const blossom) const { return blossom < _num_nodes; }
+  // Whether the tree of the labeled node already took part in an
+  // augmentation in this stage
+  bool is_frozen(NodeId const node_id) const {
+    return _frozen[_tree[top(node_id)]] == _stage;
+  }
+
+  // Sub-blossom of b at index idx, which may be negative to count from the
+  // back
+  NodeId child(NodeId const b, std::ptrdiff_t const idx) const {
+    std::ptrdiff_t const size = _blossom_children[b].size();
+    return _blossom_children[b][(idx % size + size) % size];
+  }
+  Endpoint child_end(NodeId const b, std::ptrdiff_t const idx) const {
+    std::ptrdiff_t const size = _blossom_ends[b].size();
+    return _blossom_ends[b][(idx % size + size) % size];
+  }
+  std::ptrdiff_t child_index(NodeId const b, NodeId const sub_blossom) const {
+    return std::find(_blossom_children[b].begin(),
+                     _blossom_children[b].end(), sub_blossom) -
+           _blossom_children[b].begin();
+  }
+
+  // Collects the nodes of the blossom into _leaves
+  std::vector<NodeId> const &leaves(NodeId blossom);
+
+  void settle_dual(NodeId blossom);
+  void push_best_edges();
+  EdgeId tightest_free_edge();
+  EdgeId tightest_even_edge();
+  NodeId tightest_odd_blossom();
+  void assign_label(NodeId node_id, Label label, Endpoint end);
+  NodeId scan_blossom(NodeId a, NodeId b);
+  void add_blossom(NodeId base, EdgeId edge_id);
+  void update_best_edge_to(NodeId blossom, EdgeId edge_id);
+  void expand_blossom(NodeId blossom, bool end_of_stage);
+  void free_blossom(NodeId blossom);
+  void augment_blossom(NodeId blossom, NodeId node_id);
+  void augment_matching(EdgeId edge_id);
+  void begin_stage();
+  std::size_t scan_queue();
+  void update_duals();
+
+  NodeId const _num_nodes;
+  std::vector<Weight> const &_weights;
+  std::vector<NodeId> _endpoint;
+  // Remote endpoints of the edges of every node, in CSR format
+  std::vector<std::size_t> _first_end;
+  std::vector<Endpoint> _remote_ends;
+
+  std::vector<Endpoint> _mate;
+  std::vector<std::uint8_t> _label;
+  std::vector<Endpoint> _label_end;
+  BlossomUnionFind _blossoms;
+  std::vector<NodeId> _blossom_parent;
+  std::vector<std::vector<NodeId>> _blossom_children;
+  std::vector<std::vector<Endpoint>> _blossom_ends;
+  std::vector<NodeId> _blossom_base;
+  std::vector<NodeId> _unused_blossoms;
+  // Dual of every node and blossom, next to the total dual change at which
+  // the pending change of a top-level id was last written out; scanning an
+  // edge reads both
+  struct Dual {
+    Weight value;
+    Weight base;
+  };
+  std::vector<Dual> _dual;
+  Weight _dual_change = 0;
+
+  // Tightest edge from an unlabeled node or an even blossom to an even
+  // blossom, and its key as in the heaps. For even non-trivial blossoms,
+  // _best_edges lists the tightest edge to each neighboring even blossom, so
+  // the list does not have to be recomputed from the nodes when the blossom
+  // becomes a sub-blossom.
+  std::vector<EdgeId> _best_edge;
+  std::vector<Weight> _best_key;
+  std::vector<std::vector<EdgeId>> _best_edges;
+  std::vector<char> _has_best_edges;
+  std::vector<EdgeId> _best_edge_to;
+  std::vector<NodeId> _best_edge_touched;
+
+  // Min-heaps of the best edges of unlabeled nodes (their slack shrinks by
+  // the dual change), of the best edges of even blossoms (twice the dual
+  // change) and of the duals of odd blossoms. Entries that are no longer
+  // valid are skipped when they reach the top.
+  std::vector<HeapEntry> _free_edges;
+  std::vector<HeapEntry> _even_edges;
+  std::vector<HeapEntry> _odd_blossoms;
+  // Ids whose best edge changed since the heaps were last updated
+  std::vector<char> _heap_pending;
+  std::vector<NodeId> _heap_updates;
+
+  // Tight edges found in the current stage, ids labeled in the current stage
+  // and ids whose best edge was set in the current stage, all stamped with
+  // the stage
+  std::vector<std::uint32_t> _allowed;
+  std::vector<std::uint32_t> _labeled_stage;
+  std::vector<std::uint32_t> _best_edge_stage;
+  std::uint32_t _stage = 0;
+  std::vector<NodeId> _labeled;
+  std::vector<NodeId> _with_best_edge;
+  // Exposed nodes with at least one edge, the roots of the next stage
+  std::vector<NodeId> _exposed;
+  // Root of the tree of every labeled top-level blossom, and the stage in
+  // which the tree of a root was frozen
+  std::vector<NodeId> _tree;
+  std::vector<std::uint32_t> _frozen;
+
+  std::vector<NodeId> _queue;
+  std::vector<NodeId> _leaves;
+  std::vector<NodeId> _stack;
+  std::vector<NodeId> _path;
+  std::vector<std::pair<NodeId, NodeId>> _pending_augmentations;
+
+  // Result of the last update_duals(): whether the stage is over
+  bool _stage_done = false;
+};
+
+WeightedBlossomSolver::WeightedBlossomSolver(NodeId const num_nodes,
+                                             std::vector<Edge> const &edges,
+                                             std::vector<Weight> const &weights)
+    : _num_nodes(num_nodes), _weights(weights), _endpoint(2 * edges.size()),
+      _first_end(num_nodes + 1, 0), _remote_ends(2 * edges.size()),
+      _mate(num_nodes, no_endpoint), _label(2 * num_nodes, UNLABELED),
+      _label_end(2 * num_nodes, no_endpoint), _blossoms(num_nodes),
+      _blossom_parent(2 * num_nodes, invalid_node_id),
+      _blossom_children(2 * num_nodes), _blossom_ends(2 * num_nodes),
+      _blossom_base(2 * num_nodes, invalid_node_id),
+      _dual(2 * num_nodes, Dual{0, 0}),
+      _best_edge(2 * num_nodes, no_edge), _best_key(2 * num_nodes, 0),
+      _best_edges(2 * num_nodes), _has_best_edges(2 * num_nodes, false),
+      _best_edge_to(2 * num_nodes, no_edge),
+      _heap_pending(2 * num_nodes, false), _allowed(edges.size(), 0),
+      _labeled_stage(2 * num_nodes, 0), _best_edge_stage(2 * num_nodes, 0),
+      _tree(2 * num_nodes, invalid_node_id), _frozen(num_nodes, 0) {
+  for (EdgeId edge_id = 0; edge_id < edges.size(); ++edge_id) {
+    _endpoint[2 * edge_id] = edges[edge_id].first;
+    _endpoint[2 * edge_id + 1] = edges[edge_id].second;
+    ++_first_end[edges[edge_id].first + 1];
+    ++_first_end[edges[edge_id].second + 1];
+  }
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    _first_end[node_id + 1] += _first_end[node_id];
+  }
+  std::vector<std::size_t> fill(_first_end.begin(), _first_end.end() - 1);
+  for (EdgeId edge_id = 0; edge_id < edges.size(); ++edge_id) {
+    _remote_ends[fill[edges[edge_id].first]++] = 2 * edge_id + 1;
+    _remote_ends[fill[edges[edge_id].second]++] = 2 * edge_id;
+  }
+
+  // Start with dual max_weight at every node, which makes all slacks
+  // non-negative
+  Weight const max_weight =
+      weights.empty() ? 0 : *std::max_element(weights.begin(), weights.end());
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    _blossom_base[node_id] = node_id;
+    _dual[node_id].value = max_weight;
+  }
+  for (NodeId blossom = 2 * num_nodes; blossom > num_nodes; --blossom) {
+    _unused_blossoms.push_back(blossom - 1);
+  }
+  // Isolated nodes can stay exposed without taking part in any stage
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    if (_first_end[node_id] != _first_end[node_id + 1]) {
+      _exposed.push_back(node_id);
+    }
+  }
+}
+
+std::vector<NodeId> const &WeightedBlossomSolver::leaves(NodeId const blossom) {
+  _leaves.clear();
+  _stack.assign(1, blossom);
+  while (not _stack.empty()) {
+    NodeId const current = _stack.back();
+    _stack.pop_back();
+    if (is_trivial(current)) {
+      _leaves.push_back(current);
+    } else {
+      _stack.insert(_stack.end(), _blossom_children[current].begin(),
+                    _blossom_children[current].end());
+    }
+  }
+  return _leaves;
+}
+
+// Writes the pending dual change of the top-level blossom into the duals of
+// its nodes and its own dual
+void WeightedBlossomSolver::settle_dual(NodeId const blossom) {
+  Weight const change = pending_change(blossom);
+  _dual[blossom].base = _dual_change;
+  if (change == 0) {
+    return;
+  }
+  if (is_trivial(blossom)) {
+    _dual[blossom].value += change;
+    return;
+  }
+  for (NodeId const node_id : leaves(blossom)) {
+    _dual[node_id].value += change;
+  }
+  _dual[blossom].value -= change;
+}
+
+// Even ids keep their edge to another even blossom, the others (nodes) their
+// edge to an even node. A heap that got at least as many new entries as it
+// had before is rebuilt in linear time instead of sifting up every entry.
+void WeightedBlossomSolver::push_best_edges() {
+  std::size_t const num_free = _free_edges.size();
+  std::size_t const num_even = _even_edges.size();
+  for (NodeId const id : _heap_updates) {
+    _heap_pending[id] = false;
+    EdgeId const edge_id = _best_edge[id];
+    if (edge_id == no_edge) {
+      continue;
+    }
+    HeapEntry const entry{_best_key[id], id, edge_id};
+    if (_label[id] & EVEN) {
+      _even_edges.push_back(entry);
+    } else {
+      _free_edges.push_back(entry);
+    }
+  }
+  _heap_updates.clear();
+
+  for (auto [heap, old_size] :
+       {std::make_pair(&_free_edges, num_free),
+        std::make_pair(&_even_edges, num_even)}) {
+    if (heap->size() >= 2 * old_size) {
+      std::make_heap(heap->begin(), heap->end(), LargerKey());
+      continue;
+    }
+    for (auto it = heap->begin() + old_size; it != heap->end(); ++it) {
+      std::push_heap(heap->begin(), it + 1, LargerKey());
+    }
+  }
+}
+
+// The tightest_* functions return the valid entry with the smallest key
+// without removing it. Entries whose node or blossom changed its label, or
+// whose node got a better edge, are dropped on the way. A node that was in an
+// odd blossom for a while gets a new entry when the blossom is expanded, but
+// its old entry for the same edge has too small a key and is dropped as well.
+EdgeId WeightedBlossomSolver::tightest_free_edge() {
+  while (not _free_edges.empty()) {
+    HeapEntry const &entry = _free_edges.front();
+    if (_best_edge[entry.id] == entry.edge_id and
+        _label[top(entry.id)] == UNLABELED and
+        _best_key[entry.id] == entry.key) {
+      assert(entry.key == slack(entry.edge_id) + _dual_change);
+      return entry.edge_id;
+    }
+    pop_entry(_free_edges);
+  }
+  return no_edge;
+}
+
+EdgeId WeightedBlossomSolver::tightest_even_edge() {
+  while (not _even_edges.empty()) {
+    HeapEntry const &entry = _even_edges.front();
+    if (_best_edge[entry.id] == entry.edge_id and
+        _blossom_parent[entry.id] == invalid_node_id and
+        (_label[entry.id] & EVEN)) {
+      assert(entry.key == slack(entry.edge_id) + 2 * _dual_change);
+      return entry.edge_id;
+    }
+    pop_entry(_even_edges);
+  }
+  return no_edge;
+}
+
+NodeId WeightedBlossomSolver::tightest_odd_blossom() {
+  while (not _odd_blossoms.empty()) {
+    HeapEntry const &entry = _odd_blossoms.front();
+    if (_blossom_base[entry.id] != invalid_node_id and
+        _blossom_parent[entry.id] == invalid_node_id and
+        _label[entry.id] == ODD) {
+      assert(entry.key == blossom_dual(entry.id) + _dual_change);
+      return entry.id;
+    }
+    pop_entry(_odd_blossoms);
+  }
+  return invalid_node_id;
+}
+
+// Labels the top-level blossom of node_id, which is reached through the
+// remote endpoint end. An odd blossom's base is matched, so its mate becomes
+// even.
+void WeightedBlossomSolver::assign_label(NodeId const node_id,
+                                         Label const label,
+                                         Endpoint const end) {
+  NodeId const blossom = top(node_id);
+  assert(_label[node_id] == UNLABELED and _label[blossom] == UNLABELED);
+  set_label(node_id, label);
+  set_label(blossom, label);
+  _tree[node_id] = _tree[blossom] =
+      end == no_endpoint ? node_id : _tree[top(_endpoint[end])];
+  _label_end[node_id] = _label_end[blossom] = end;
+  _best_edge[node_id] = _best_edge[blossom] = no_edge;
+  if (label == EVEN) {
+    leaves(blossom);
+    _queue.insert(_queue.end(), _leaves.begin(), _leaves.end());
+  } else {
+    Endpoint const base_mate = _mate[_blossom_base[blossom]];
+    assert(base_mate != no_endpoint);
+    assign_label(_endpoint[base_mate], EVEN, base_mate ^ 1);
+  }
+}
+
+// Follows the tree paths from the even nodes a and b towards their roots.
+// Returns the base of the new blossom if they meet, or invalid_node_id if
+// they end in different roots (so there is an augmenting path).
+NodeId WeightedBlossomSolver::scan_blossom(NodeId a, NodeId b) {
+  _path.clear();
+  NodeId base = invalid_node_id;
+  while (a != invalid_node_id or b != invalid_node_id) {
+    NodeId blossom = top(a);
+    if (_label[blossom] & BREADCRUMB) {
+      base = _blossom_base[blossom];
+      break;
+    }
+    assert(_label[blossom] == EVEN);
+    _path.push_back(blossom);
+    _label[blossom] = EVEN | BREADCRUMB;
+    if (_label_end[blossom] == no_endpoint) {
+      a = invalid_node_id; // reached the root
+    } else {
+      blossom = top(_endpoint[_label_end[blossom]]);
+      assert(_label[blossom] == ODD);
+      a = _endpoint[_label_end[blossom]];
+    }
+    if (b != invalid_node_id) {
+      std::swap(a, b);
+    }
+  }
+  for (NodeId const blossom : _path) {
+    _label[blossom] = EVEN;
+  }
+  return base;
+}
+
+void WeightedBlossomSolver::update_best_edge_to(NodeId const blossom,
+                                                EdgeId const edge_id) {
+  NodeId first = _endpoint[2 * edge_id];
+  NodeId second = _endpoint[2 * edge_id + 1];
+  if (top(second) == blossom) {
+    std::swap(first, second);
+  }
+  NodeId const other = top(second);
+  if (other != blossom and _label[other] == EVEN) {
+    if (_best_edge_to[other] == no_edge) {
+      _best_edge_touched.push_back(other);
+      _best_edge_to[other] = edge_id;
+    } else if (slack(edge_id) < slack(_best_edge_to[other])) {
+      _best_edge_to[other] = edge_id;
+    }
+  }
+}
+
+// Shrinks the cycle closed by the tight edge between two even nodes of the
+// same tree into a new blossom with the given base.
+void WeightedBlossomSolver::add_blossom(NodeId const base,
+                                        EdgeId const edge_id) {
+  NodeId const base_blossom = top(base);
+  NodeId a_blossom = top(_endpoint[2 * edge_id]);
+  NodeId b_blossom = top(_endpoint[2 * edge_id + 1]);
+  NodeId const blossom = _unused_blossoms.back();
+  _unused_blossoms.pop_back();
+  _blossom_base[blossom] = base;
+  _blossom_parent[blossom] = invalid_node_id;
+  // The pending dual changes of the sub-blossoms are written out before they
+  // stop being top-level
+  settle_dual(base_blossom);
+  _blossom_parent[base_blossom] = blossom;
+
+  // Collect the sub-blossoms from the base around the cycle
+  std::vector<NodeId> &children = _blossom_children[blossom];
+  std::vector<Endpoint> &ends = _blossom_ends[blossom];
+  children.clear();
+  ends.clear();
+  while (a_blossom != base_blossom) {
+    settle_dual(a_blossom);
+    _blossom_parent[a_blossom] = blossom;
+    children.push_back(a_blossom);
+    ends.push_back(_label_end[a_blossom]);
+    assert(_label_end[a_blossom] != no_endpoint);
+    a_blossom = top(_endpoint[_label_end[a_blossom]]);
+  }
+  children.push_back(base_blossom);
+  std::reverse(children.begin(), children.end());
+  std::reverse(ends.begin(), ends.end());
+  ends.push_back(2 * edge_id);
+  while (b_blossom != base_blossom) {
+    settle_dual(b_blossom);
+    _blossom_parent[b_blossom] = blossom;
+    children.push_back(b_blossom);
+    ends.push_back(_label_end[b_blossom] ^ 1);
+    assert(_label_end[b_blossom] != no_endpoint);
+    b_blossom = top(_endpoint[_label_end[b_blossom]]);
+  }
+
+  assert(_label[base_blossom] == EVEN);
+  set_label(blossom, EVEN);
+  _tree[blossom] = _tree[base_blossom];
+  _label_end[blossom] = _label_end[base_blossom];
+  _dual[blossom].value = 0;
+  for (NodeId const sub_blossom : children) {
+    if (_label[sub_blossom] == ODD) {
+      leaves(sub_blossom); // formerly odd nodes become even
+      _queue.insert(_queue.end(), _leaves.begin(), _leaves.end());
+    }
+    _blossoms.unite(base, _blossom_base[sub_blossom]);
+  }
+  _blossoms.set_blossom(base, base, blossom);
+
+  // Merge the tightest edges of the sub-blossoms to other even blossoms
+  for (NodeId const sub_blossom : children) {
+    if (_has_best_edges[sub_blossom]) {
+      for (EdgeId const other_edge_id : _best_edges[sub_blossom]) {
+        update_best_edge_to(blossom, other_edge_id);
+      }
+    } else {
+      for (NodeId const node_id : leaves(sub_blossom)) {
+        for (std::size_t idx = _first_end[node_id];
+             idx < _first_end[node_id + 1]; ++idx) {
+          update_best_edge_to(blossom, _remote_ends[idx] / 2);
+        }
+      }
+    }
+    _best_edges[sub_blossom].clear();
+    _has_best_edges[sub_blossom] = false;
+    _best_edge[sub_blossom] = no_edge;
+  }
+  _best_edges[blossom].clear();
+  _has_best_edges[blossom] = true;
+  _best_edge[blossom] = no_edge;
+  for (NodeId const other : _best_edge_touched) {
+    EdgeId const best_id = _best_edge_to[other];
+    _best_edges[blossom].push_back(best_id);
+    Weight const best_id_slack = slack(best_id);
+    if (_best_edge[blossom] == no_edge or
+        best_id_slack < best_slack(blossom)) {
+      set_best_edge(blossom, best_id, best_id_slack);
+    }
+    _best_edge_to[other] = no_edge;
+  }
+  _best_edge_touched.clear();
+}
+
+void WeightedBlossomSolver::free_blossom(NodeId const blossom) {
+  _label[blossom] = UNLABELED;
+  _label_end[blossom] = no_endpoint;
+  _blossom_children[blossom].clear();
+  _blossom_ends[blossom].clear();
+  _blossom_base[blossom] = invalid_node_id;
+  _best_edges[blossom].clear();
+  _has_best_edges[blossom] = false;
+  _best_edge[blossom] = no_edge;
+  _unused_blossoms.push_back(blossom);
+}
+
+// Turns the sub-blossoms of a top-level blossom into top-level blossoms. At
+// the end of a stage, sub-blossoms with zero dual are expanded as well. An odd
+// blossom expanded during a stage has its sub-blossoms relabeled so that the
+// tree stays alternating.
+void WeightedBlossomSolver::expand_blossom(NodeId const blossom,
+                                           bool const end_of_stage) {
+  settle_dual(blossom);
+  for (NodeId const node_id : leaves(blossom)) {
+    _blossoms.reset(node_id);
+  }
+  std::vector<NodeId> expand(1, blossom);
+  while (not expand.empty()) {
+    NodeId const current = expand.back();
+    expand.pop_back();
+    for (NodeId const sub_blossom : _blossom_children[current]) {
+      _blossom_parent[sub_blossom] = invalid_node_id;
+      _dual[sub_blossom].base = _dual_change;
+      if (is_trivial(sub_blossom)) {
+        continue;
+      }
+      if (end_of_stage and _dual[sub_blossom].value == 0) {
+        expand.push_back(sub_blossom);
+        continue;
+      }
+      NodeId const base = _blossom_base[sub_blossom];
+      for (NodeId const node_id : leaves(sub_blossom)) {
+        _blossoms.unite(base, node_id);
+      }
+      _blossoms.set_blossom(base, base, sub_blossom);
+    }
+    if (current != blossom) {
+      free_blossom(current);
+    }
+  }
+
+  if (not end_of_stage and _label[blossom] == ODD) {
+    // Walk from the sub-blossom through which the blossom was reached to the
+    // base, in the direction in which the path has even length
+    assert(_label_end[blossom] != no_endpoint);
+    NodeId const entry_child =
+        top(_endpoint[_label_end[blossom] ^ 1]);
+    std::ptrdiff_t idx = child_index(blossom, entry_child);
+    std::ptrdiff_t step = -1;
+    Endpoint end_trick = 1;
+    if (idx & 1) {
+      idx -= _blossom_children[blossom].size();
+      step = 1;
+      end_trick = 0;
+    }
+    Endpoint end = _label_end[blossom];
+    while (idx != 0) {
+      // Relabel the odd sub-blossom
+      _label[_endpoint[end ^ 1]] = UNLABELED;
+      _label[_endpoint[child_end(blossom, idx - end_trick) ^ end_trick ^ 1]] =
+          UNLABELED;
+      assign_label(_endpoint[end ^ 1], ODD, end);
+      // Step to the next even sub-blossom and then to the next odd one
+      allow(child_end(blossom, idx - end_trick) / 2);
+      idx += step;
+      end = child_end(blossom, idx - end_trick) ^ end_trick;
+      allow(end / 2);
+      idx += step;
+    }
+    // The base sub-blossom becomes odd without labeling its mate, which is
+    // already even
+    NodeId sub_blossom = child(blossom, idx);
+    set_label(_endpoint[end ^ 1], ODD);
+    set_label(sub_blossom, ODD);
+    _tree[sub_blossom] = _tree[blossom];
+    _label_end[_endpoint[end ^ 1]] = _label_end[sub_blossom] = end;
+    _best_edge[sub_blossom] = no_edge;
+
+    // The other sub-blossoms leave the tree unless one of their nodes is
+    // reached by a tight edge from an even node outside
+    idx += step;
+    while (child(blossom, idx) != entry_child) {
+      sub_blossom = child(blossom, idx);
+      idx += step;
+      if (_label[sub_blossom] == EVEN) {
+        continue; // got relabeled through one of its nodes just now
+      }
+      NodeId reached = invalid_node_id;
+      for (NodeId const node_id : leaves(sub_blossom)) {
+        if (_label[node_id] != UNLABELED) {
+          reached = node_id;
+          break;
+        }
+      }
+      if (reached != invalid_node_id) {
+        assert(_label[reached] == ODD and
+               top(reached) == sub_blossom);
+        _label[reached] = UNLABELED;
+        _label[_endpoint[_mate[_blossom_base[sub_blossom]]]] = UNLABELED;
+        assign_label(reached, ODD, _label_end[reached]);
+      } else {
+        // The heap dropped the best edges of its nodes while it was odd
+        for (NodeId const node_id : leaves(sub_blossom)) {
+          if (_best_edge[node_id] != no_edge) {
+            set_best_edge(node_id, _best_edge[node_id],
+                          slack(_best_edge[node_id]));
+          }
+        }
+      }
+    }
+  }
+  free_blossom(blossom);
+}
+
+// Swaps matched and unmatched edges inside the blossom so that node_id becomes
+// its base. Nested sub-blossoms are handled with an explicit stack; their
+// order does not matter since each one only changes its own edges.
+void WeightedBlossomSolver::augment_blossom(NodeId const blossom,
+                                            NodeId const node_id) {
+  _pending_augmentations.assign(1, {blossom, node_id});
+  while (not _pending_augmentations.empty()) {
+    auto const [current, new_base] = _pending_augmentations.back();
+    _pending_augmentations.pop_back();
+
+    NodeId sub_blossom = new_base;
+    while (_blossom_parent[sub_blossom] != current) {
+      sub_blossom = _blossom_parent[sub_blossom];
+    }
+    if (not is_trivial(sub_blossom)) {
+      _pending_augmentations.emplace_back(sub_blossom, new_base);
+    }
+
+    std::ptrdiff_t const first_idx = child_index(current, sub_blossom);
+    std::ptrdiff_t idx = first_idx;
+    std::ptrdiff_t step = -1;
+    Endpoint end_trick = 1;
+    if (idx & 1) {
+      idx -= _blossom_children[current].size();
+      step = 1;
+      end_trick = 0;
+    }
+    while (idx != 0) {
+      idx += step;
+      sub_blossom = child(current, idx);
+      Endpoint const end = child_end(current, idx - end_trick) ^ end_trick;
+      if (not is_trivial(sub_blossom)) {
+        _pending_augmentations.emplace_back(sub_blossom, _endpoint[end]);
+      }
+      idx += step;
+      sub_blossom = child(current, idx);
+      if (not is_trivial(sub_blossom)) {
+        _pending_augmentations.emplace_back(sub_blossom, _endpoint[end ^ 1]);
+      }
+      _mate[_endpoint[end]] = end ^ 1;
+      _mate[_endpoint[end ^ 1]] = end;
+    }
+
+    // Rotate the cycle so that it starts at the new base again
+    std::rotate(_blossom_children[current].begin(),
+                _blossom_children[current].begin() + first_idx,
+                _blossom_children[current].end());
+    std::rotate(_blossom_ends[current].begin(),
+                _blossom_ends[current].begin() + first_idx,
+                _blossom_ends[current].end());
+    _blossom_base[current] = new_base;
+    if (_blossom_parent[current] == invalid_node_id) {
+      _blossoms.set_blossom(new_base, new_base, current);
+    }
+  }
+}
+
+// Augments along the path through the tight edge between two even nodes of
+// different trees
+void WeightedBlossomSolver::augment_matching(EdgeId const edge_id) {
+  for (Endpoint const start : {2 * edge_id + 1, 2 * edge_id}) {
+    NodeId node_id = _endpoint[start ^ 1];
+    Endpoint end = start;
+    while (true) {
+      NodeId const even_blossom = top(node_id);
+      assert(_label[even_blossom] == EVEN);
+      if (not is_trivial(even_blossom)) {
+        augment_blossom(even_blossom, node_id);
+      }
+      _mate[node_id] = end;
+      if (_label_end[even_blossom] == no_endpoint) {
+        break; // reached the root
+      }
+      NodeId const odd_blossom =
+          top(_endpoint[_label_end[even_blossom]]);
+      assert(_label[odd_blossom] == ODD);
+      node_id = _endpoint[_label_end[odd_blossom]];
+      NodeId const odd_id = _endpoint[_label_end[odd_blossom] ^ 1];
+      if (not is_trivial(odd_blossom)) {
+        augment_blossom(odd_blossom, odd_id);
+      }
+      _mate[odd_id] = _label_end[odd_blossom];
+      end = _label_end[odd_blossom] ^ 1;
+    }
+  }
+}
+
+// Grows the forest along tight edges and returns the number of augmentations.
+// After an augmentation, its two trees are frozen until the end of the stage,
+// and the other trees keep growing, so a stage can find many augmenting paths
+// of tight edges. Duals are only updated in stages that found none.
+std::size_t WeightedBlossomSolver::scan_queue() {
+  std::size_t num_augmentations = 0;
+  while (not _queue.empty()) {
+    NodeId const node_id = _queue.back();
+    _queue.pop_back();
+    assert(_label[top(node_id)] == EVEN);
+    if (is_frozen(node_id)) {
+      continue;
+    }
+    // The duals do not change while the queue is scanned, and the blossom of
+    // the node only when a new blossom is added
+    Weight const node_dual_value = node_dual(node_id);
+    NodeId node_blossom = top(node_id);
+    for (std::size_t idx = _first_end[node_id]; idx < _first_end[node_id + 1];
+         ++idx) {
+      Endpoint const end = _remote_ends[idx];
+      EdgeId const edge_id = end / 2;
+      NodeId const neighbor_id = _endpoint[end];
+      NodeId const neighbor_blossom = top(neighbor_id);
+      if (node_blossom == neighbor_blossom or
+          (_label[neighbor_blossom] != UNLABELED and
+           _frozen[_tree[neighbor_blossom]] == _stage)) {
+        continue;
+      }
+      Weight edge_slack = 0;
+      if (not is_allowed(edge_id)) {
+        edge_slack = node_dual_value + _dual[neighbor_id].value +
+                     pending_change(neighbor_blossom) - 2 * _weights[edge_id];
+        if (edge_slack <= 0) {
+          allow(edge_id);
+        }
+      }
+
+      if (is_allowed(edge_id)) {
+        if (_label[neighbor_blossom] == UNLABELED) {
+          assign_label(neighbor_id, ODD, end ^ 1);
+        } else if (_label[neighbor_blossom] == EVEN) {
+          NodeId const base = scan_blossom(node_id, neighbor_id);
+          if (base != invalid_node_id) {
+            add_blossom(base, edge_id);
+            node_blossom = top(node_id);
+          } else {
+            _frozen[_tree[node_blossom]] = _stage;
+            _frozen[_tree[neighbor_blossom]] = _stage;
+            augment_matching(edge_id);
+            ++num_augmentations;
+            break;
+          }
+        } else if (_label[neighbor_id] == UNLABELED) {
+          // A node of an odd blossom, remember how it can be reached
+          set_label(neighbor_id, ODD);
+          _label_end[neighbor_id] = end ^ 1;
+        }
+      } else if (_label[neighbor_blossom] == EVEN) {
+        if (_best_edge[node_blossom] == no_edge or
+            edge_slack < best_slack(node_blossom)) {
+          set_best_edge(node_blossom, edge_id, edge_slack);
+        }
+      } else if (_label[neighbor_id] == UNLABELED) {
+        if (_best_edge[neighbor_id] == no_edge or
+            edge_slack < best_slack(neighbor_id)) {
+          set_best_edge(neighbor_id, edge_id, edge_slack);
+        }
+      }
+    }
+  }
+  return num_augmentations;
+}
+
+// Changes the duals by the largest amount that keeps them feasible and acts
+// on the constraint that became tight. The candidates come from the heaps, and
+// the change itself is only added to the total dual change.
+void WeightedBlossomSolver::update_duals() {
+  enum { NODE_DUAL, ODD_EDGE, EVEN_EDGE, BLOSSOM_DUAL } kind = NODE_DUAL;
+  // Decreasing the duals of even nodes by more than their minimum would make
+  // them negative, which only pays for exposed nodes. All exposed nodes are
+  // even roots and have the same, minimum dual.
+  push_best_edges();
+  Weight delta = node_dual(_exposed.front());
+  NodeId delta_blossom = invalid_node_id;
+
+  // Edge from an even to an unlabeled node becomes tight
+  EdgeId const free_edge = tightest_free_edge();
+  if (free_edge != no_edge and slack(free_edge) < delta) {
+    delta = slack(free_edge);
+    kind = ODD_EDGE;
+  }
+  // Edge between two even blossoms becomes tight (both ends move)
+  EdgeId const even_edge = tightest_even_edge();
+  if (even_edge != no_edge) {
+    Weight const edge_slack = slack(even_edge);
+    assert(edge_slack % 2 == 0);
+    if (edge_slack / 2 < delta) {
+      delta = edge_slack / 2;
+      kind = EVEN_EDGE;
+    }
+  }
+  // Dual of an odd blossom drops to zero
+  NodeId const odd_blossom = tightest_odd_blossom();
+  if (odd_blossom != invalid_node_id and blossom_dual(odd_blossom) < delta) {
+    delta = blossom_dual(odd_blossom);
+    kind = BLOSSOM_DUAL;
+    delta_blossom = odd_blossom;
+  }
+
+  _dual_change += delta;
+
+  _stage_done = false;
+  switch (kind) {
+  case NODE_DUAL:
+    _stage_done = true; // no augmenting path can improve the weight
+    break;
+  case ODD_EDGE:
+  case EVEN_EDGE:
+    // Usually many edges become tight at once; scan all of them instead of
+    // finding them one by one with updates by zero
+    for (std::vector<HeapEntry> *heap : {&_free_edges, &_even_edges}) {
+      while (true) {
+        EdgeId const edge_id = heap == &_free_edges ? tightest_free_edge()
+                                                    : tightest_even_edge();
+        if (edge_id == no_edge or slack(edge_id) != 0) {
+          break;
+        }
+        pop_entry(*heap);
+        NodeId node_id = _endpoint[2 * edge_id];
+        if (_label[top(node_id)] != EVEN) {
+          node_id = _endpoint[2 * edge_id + 1];
+        }
+        assert(_label[top(node_id)] == EVEN);
+        allow(edge_id);
+        _queue.push_back(node_id);
+      }
+    }
+    break;
+  case BLOSSOM_DUAL:
+    expand_blossom(delta_blossom, false);
+    break;
+  }
+}
+
+// Clears the labels and best edges of the previous stage and makes every
+// exposed node an even root
+void WeightedBlossomSolver::begin_stage() {
+  for (NodeId const id : _labeled) {
+    if (_blossom_parent[id] == invalid_node_id) {
+      settle_dual(id);
+    }
+    _label[id] = UNLABELED;
+    _has_best_edges[id] = false;
+  }
+  for (NodeId const id : _with_best_edge) {
+    _best_edge[id] = no_edge;
+  }
+  for (NodeId const id : _heap_updates) {
+    _heap_pending[id] = false;
+  }
+  _labeled.clear();
+  _with_best_edge.clear();
+  _heap_updates.clear();
+  _free_edges.clear();
+  _even_edges.clear();
+  _odd_blossoms.clear();
+  if (++_stage == 0) {
+    std::fill(_allowed.begin(), _allowed.end(), 0);
+    std::fill(_labeled_stage.begin(), _labeled_stage.end(), 0);
+    std::fill(_best_edge_stage.begin(), _best_edge_stage.end(), 0);
+    std::fill(_frozen.begin(), _frozen.end(), 0);
+    _stage = 1;
+  }
+  _queue.clear();
+
+  _exposed.erase(std::remove_if(_exposed.begin(), _exposed.end(),
+                                [&](NodeId const node_id) {
+                                  return _mate[node_id] != no_endpoint;
+                                }),
+                 _exposed.end());
+  for (NodeId const node_id : _exposed) {
+    assign_label(node_id, EVEN, no_endpoint);
+  }
+}
+
+void WeightedBlossomSolver::run() {
+  // Every stage but the last one ends with at least one augmentation
+  while (true) {
+    begin_stage();
+    if (_exposed.empty()) {
+      break;
+    }
+
+    std::size_t num_augmentations = 0;
+    _stage_done = false;
+    while (true) {
+      num_augmentations += scan_queue();
+      if (num_augmentations > 0) {
+        break;
+      }
+      update_duals();
+      if (_stage_done) {
+        break;
+      }
+    }
+    if (num_augmentations == 0) {
+      break;
+    }
+
+    // Blossoms whose dual dropped to zero are no longer needed
+    for (std::size_t idx = 0; idx < _labeled.size(); ++idx) {
+      NodeId const id = _labeled[idx];
+      if (not is_trivial(id) and _blossom_parent[id] == invalid_node_id and
+          _blossom_base[id] != invalid_node_id and _label[id] == EVEN and
+          blossom_dual(id) == 0) {
+        expand_blossom(id, true);
+      }
+    }
+  }
+}
+
+} // namespace
+
+Matching compute_maximum_weight_matching(NodeId const num_nodes,
+                                         std::vector<Edge> const &edges,
+                                         std::vector<Weight> const &weights,
+                                         Weight *total_weight) {
+  if (weights.size() != edges.size()) {
+    throw std::runtime_error("Every edge needs a weight.");
+  }
+  std::vector<Edge> positive_edges;
+  std::vector<Weight> positive_weights;
+  for (std::size_t edge_idx = 0; edge_idx < edges.size(); ++edge_idx) {
+    Edge const &edge = edges[edge_idx];
+    if (edge.first == edge.second) {
+      throw std::runtime_error("Weighted matching does not support loops!");
+    }
+    if (edge.first >= num_nodes or edge.second >= num_nodes) {
+      throw std::runtime_error("Edge refers to a node that does not exist.");
+    }
+    if (weights[edge_idx] > 0) {
+      positive_edges.push_back(edge);
+      positive_weights.push_back(weights[edge_idx]);
+    }
+  }
+
+  WeightedBlossomSolver solver(num_nodes, positive_edges, positive_weights);
+  solver.run();
+
+  Matching matching(num_nodes);
+  Weight weight = 0;
+  for (NodeId node_id = 0; node_id < num_nodes; ++node_id) {
+    NodeId const mate_id = solver.mate(node_id);
+    if (mate_id != invalid_node_id and node_id < mate_id) {
+      matching.match(node_id, mate_id);
+      weight += positive_weights[solver.matched_edge(node_id)];
+    }
+  }
+  if (total_weight) {
+    *total_weight = weight;
+  }
+  return matching;
+}
+
+} // namespace ED
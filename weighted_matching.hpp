@@ -0,0 +1,49 @@
+#ifndef WEIGHTED_MATCHING_HPP
+#define WEIGHTED_MATCHING_HPP
+
+/**
+   @file weighted_matching.hpp
+
+   @brief Maximum weight matching by Edmonds' primal-dual blossom algorithm.
+**/
+
+#include <vector>
+
+#include "graph.hpp"
+#include "matching.hpp"
+
+namespace ED {
+
+/**
+   @brief Computes a matching of maximum total weight (not necessarily of
+maximum cardinality) of the graph on @c num_nodes nodes with the given edges.
+
+   @c weights[i] is the weight of @c edges[i]. Parallel edges are allowed,
+loops are not. Edges of non-positive weight are never needed for an optimum
+and are dropped up front.
+
+   The algorithm works in stages of alternating forest growth from all exposed
+nodes, like the cardinality engines, but only uses edges that are tight with
+respect to a dual solution (node and blossom potentials). A stage augments
+along as many vertex-disjoint tight paths as it finds; only if there are none,
+the duals are changed by the largest amount that keeps them feasible, and all
+edges that become tight are scanned at once. For every node and blossom in the
+forest, the tightest edge to an even node is kept up to date in one of two
+heaps (unlabeled nodes, even blossoms); a third heap holds the duals of odd
+blossoms. The duals themselves change lazily through a running total of all
+changes, so a dual update costs O(log m) instead of a pass over the forest. The
+nodes of the top-level blossoms are kept in a @c BlossomUnionFind. Blossoms are
+kept across stages as long as their dual is positive. With integral weights
+all duals stay integral. Shrinking and expanding a blossom still visits all of
+its nodes, so the running time remains O(n^3) in the worst case.
+
+   @param total_weight If not null, receives the weight of the matching.
+**/
+Matching compute_maximum_weight_matching(NodeId const num_nodes,
+                                         std::vector<Edge> const &edges,
+                                         std::vector<Weight> const &weights,
+                                         Weight *total_weight = nullptr);
+
+} // namespace ED
+
+#endif /* WEIGHTED_MATCHING_HPP */